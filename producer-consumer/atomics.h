@@ -0,0 +1,56 @@
+#ifndef PRODUCER_CONSUMER_ATOMICS_H
+#define PRODUCER_CONSUMER_ATOMICS_H
+
+/**
+ * Atomics for the Lock-Free Queues
+ *
+ * Lock-free queues declare their shared state as Atomic<T> instead of
+ * std::atomic<T>. They also mark plain accesses to payloads that another
+ * thread hands over with PC_MODEL_READ / PC_MODEL_WRITE (or
+ * PC_MODEL_ACCESS(address, write)), and freed payload
+ * memory with PC_MODEL_FREE. In a normal build Atomic<T> is std::atomic<T>
+ * and the macros compile to nothing.
+ *
+ * Built with PRODUCER_CONSUMER_MODEL_CHECK, the same queue code runs
+ * against ModelAtomic<T> and the data race checks of model_check.h, so the
+ * model checker can explore it (see model_check_test.cpp). A new lock-free
+ * queue should use these and get a scenario there.
+ */
+
+#ifdef PRODUCER_CONSUMER_MODEL_CHECK
+
+#include "model_check.h"
+
+template<typename T>
+using Atomic = ModelAtomic<T>;
+
+#define PC_MODEL_ACCESS(address, write)                                      \
+    do {                                                                     \
+        if (ModelChecker* pc_model_checker_ = ModelChecker::running()) {     \
+            pc_model_checker_->access((address), (write));                   \
+        }                                                                    \
+    } while (0)
+#define PC_MODEL_READ(address) PC_MODEL_ACCESS(address, false)
+#define PC_MODEL_WRITE(address) PC_MODEL_ACCESS(address, true)
+#define PC_MODEL_FREE(address)                                               \
+    do {                                                                     \
+        if (ModelChecker* pc_model_checker_ = ModelChecker::running()) {     \
+            pc_model_checker_->release(address);                             \
+        }                                                                    \
+    } while (0)
+
+#else
+
+#include <atomic>
+
+template<typename T>
+using Atomic = std::atomic<T>;
+
+#define PC_MODEL_ACCESS(address, write) ((void)0)
+#define PC_MODEL_READ(address) ((void)0)
+#define PC_MODEL_WRITE(address) ((void)0)
+#define PC_MODEL_FREE(address) ((void)0)
+
+#endif
+
+#endif // PRODUCER_CONSUMER_ATOMICS_H
@@ -0,0 +1,163 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer.h"
+#include "mpsc_queue.h"
+#include "perf_counters.h"
+#include "ring_buffer.h"
+#include "spmc_ring.h"
+#include "spsc_ring.h"
+
+/**
+ * Buffer Backend Benchmark
+ *
+ * Runs every queue backend in the producer:consumer shapes it supports and
+ * reports, per message, the hardware counters behind the throughput number
+ * (see perf_counters.h): cycles, instructions, cache misses, LLC misses,
+ * branch misses and context switches.
+ *
+ *   backend-benchmark            human-readable table
+ *   backend-benchmark --csv      one CSV row per run, for CI to diff
+ *
+ * Counters the machine cannot provide are printed as "n/a" (or empty CSV
+ * fields).
+ */
+
+const int64_t NUM_MESSAGES = 200000;
+
+struct Shape {
+    int producers;
+    int consumers;
+};
+
+// Runs one backend in one shape; returns wall time in seconds
+template<typename Queue>
+double run(Queue& queue, Shape shape) {
+    int64_t per_producer = NUM_MESSAGES / shape.producers;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < shape.consumers; ++c) {
+        consumers.emplace_back([&queue] {
+            int64_t item;
+            int64_t sum = 0;
+            while (queue.pop(item)) {
+                sum += item;
+            }
+            (void)sum;
+        });
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < shape.producers; ++p) {
+        producers.emplace_back([&queue, per_producer] {
+            for (int64_t i = 0; i < per_producer; ++i) {
+                queue.push(i);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    queue.shutdown();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Benchmark {
+    std::string backend;
+    Shape shape;
+    std::function<double(Shape)> run;
+};
+
+template<typename Queue, typename... Args>
+Benchmark benchmark(const std::string& backend, Shape shape, Args... args) {
+    return Benchmark{backend, shape, [args...](Shape s) {
+        Queue queue(args...);
+        return run(queue, s);
+    }};
+}
+
+int main(int argc, char* argv[]) {
+    bool csv = argc > 1 && std::strcmp(argv[1], "--csv") == 0;
+
+    std::vector<Benchmark> benchmarks;
+    for (Shape shape : {Shape{1, 1}, Shape{4, 1}, Shape{1, 4}, Shape{4, 4}}) {
+        benchmarks.push_back(benchmark<Buffer<int64_t>>("Buffer", shape, size_t(1024)));
+        benchmarks.push_back(benchmark<RingBuffer<int64_t>>("RingBuffer", shape, size_t(1024)));
+        if (shape.consumers == 1) {
+            benchmarks.push_back(benchmark<MpscQueue<int64_t>>("MpscQueue", shape));
+        }
+        if (shape.producers == 1) {
+            benchmarks.push_back(benchmark<SpmcRing<int64_t>>("SpmcRing", shape, size_t(1024)));
+        }
+        if (shape.producers == 1 && shape.consumers == 1) {
+            benchmarks.push_back(benchmark<SpscRing<int64_t>>("SpscRing", shape, size_t(1024)));
+        }
+    }
+
+    if (csv) {
+        std::printf("backend,producers,consumers,messages,seconds");
+        for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+            std::printf(",%s_per_msg", PerfCounters::name(static_cast<PerfCounters::Event>(e)));
+        }
+        std::printf("\n");
+    } else {
+        std::printf("\n=== BACKEND BENCHMARK ===\n");
+        std::printf("%lld messages per run; counters are per message\n\n", static_cast<long long>(NUM_MESSAGES));
+        std::printf("%-11s %5s %9s %9s %9s %9s %9s %9s %9s %9s\n", "backend", "P:C", "ms", "Mmsg/s", "cycles",
+                    "instr", "cache-mis", "llc-miss", "br-miss", "ctx-sw");
+    }
+
+    bool warned = false;
+    for (Benchmark& bench : benchmarks) {
+        PerfCounters counters;              // Opened before the run starts its threads
+        if (!csv && !warned && !counters.any_available()) {
+            std::printf("[MAIN] perf_event_open is not available here; counters shown as n/a\n");
+            warned = true;
+        }
+        counters.start();
+        double seconds = bench.run(bench.shape);
+        PerfCounters::Reading reading = counters.stop();
+
+        int64_t messages = NUM_MESSAGES / bench.shape.producers * bench.shape.producers;
+        if (csv) {
+            std::printf("%s,%d,%d,%lld,%.6f", bench.backend.c_str(), bench.shape.producers, bench.shape.consumers,
+                        static_cast<long long>(messages), seconds);
+            for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+                if (reading.valid[e]) {
+                    std::printf(",%.4f", static_cast<double>(reading.values[e]) / static_cast<double>(messages));
+                } else {
+                    std::printf(",");
+                }
+            }
+            std::printf("\n");
+            continue;
+        }
+
+        char shape[16];
+        std::snprintf(shape, sizeof(shape), "%d:%d", bench.shape.producers, bench.shape.consumers);
+        std::printf("%-11s %5s %9.1f %9.2f", bench.backend.c_str(), shape, seconds * 1000.0,
+                    static_cast<double>(messages) / seconds / 1e6);
+        for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+            if (reading.valid[e]) {
+                std::printf(" %9.2f", static_cast<double>(reading.values[e]) / static_cast<double>(messages));
+            } else {
+                std::printf(" %9s", "n/a");
+            }
+        }
+        std::printf("\n");
+    }
+
+    if (!csv) {
+        std::printf("\n=== BACKEND BENCHMARK COMPLETED ===\n\n");
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef PRODUCER_CONSUMER_BACKOFF_H
+#define PRODUCER_CONSUMER_BACKOFF_H
+
+#include <thread>
+
+#ifdef PRODUCER_CONSUMER_MODEL_CHECK
+#include "model_check.h"
+#endif
+
+/**
+ * Spin-then-yield backoff for the blocking calls of lock-free queues.
+ *
+ * Lock-free queues have no condition variable to sleep on. A waiting thread
+ * spins briefly (cheap when the other side is just about to publish) and
+ * then starts yielding its time slice so it does not burn a whole core.
+ *
+ * Under the model checker (see model_check.h) a pause tells the scheduler
+ * that the thread is waiting for another thread to store something.
+ */
+class Backoff {
+private:
+    static const int SPIN_LIMIT = 64;
+    int spins_ = 0;
+
+public:
+    void pause() {
+#ifdef PRODUCER_CONSUMER_MODEL_CHECK
+        if (ModelChecker* checker = ModelChecker::running()) {
+            checker->spin();
+            return;
+        }
+#endif
+        if (spins_ < SPIN_LIMIT) {
+            ++spins_;
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();         // Tell the CPU this is a spin-wait loop
+#endif
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    void reset() { spins_ = 0; }
+};
+
+#endif // PRODUCER_CONSUMER_BACKOFF_H
@@ -0,0 +1,95 @@
+#ifndef PRODUCER_CONSUMER_BATCH_HANDLER_H
+#define PRODUCER_CONSUMER_BATCH_HANDLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "broadcast_ring.h"
+#include "buffer.h"
+
+/**
+ * Batch-Aware Event Handlers
+ *
+ * Consumer::consume handles one item at a time, so anything expensive it
+ * does per item (a flush, a write() syscall, a network send) is paid per
+ * message. An EventHandler instead learns where a batch ends:
+ *
+ *   class FileWriter : public EventHandler<std::string> {
+ *       void on_event(const std::string& line, int64_t sequence, bool end_of_batch) override {
+ *           pending_ += line;
+ *           if (end_of_batch) { write(fd_, pending_); pending_.clear(); }   // one syscall per batch
+ *       }
+ *   };
+ *
+ * BatchEventProcessor drives a handler: it waits for data, drains
+ * everything available at that moment in one pass, and flags the last item
+ * of that pass with end_of_batch = true. Under light load batches are
+ * small (low latency); under heavy load they grow on their own, which is
+ * exactly when coalescing pays off.
+ *
+ * Works on a Buffer (pop_batch() takes all available items under one lock)
+ * and on a BroadcastRing reader (entries are read in place).
+ */
+
+template<typename T>
+class EventHandler {
+public:
+    virtual ~EventHandler() = default;
+
+    // sequence counts items seen by this handler (ring sequence for rings)
+    virtual void on_event(const T& item, int64_t sequence, bool end_of_batch) = 0;
+
+    virtual void on_start() {}
+    virtual void on_shutdown() {}
+};
+
+template<typename T>
+class BatchEventProcessor {
+private:
+    EventHandler<T>& handler_;
+    uint64_t batches_ = 0;
+    uint64_t events_ = 0;
+    size_t max_batch_;
+
+public:
+    explicit BatchEventProcessor(EventHandler<T>& handler, size_t max_batch = SIZE_MAX)
+        : handler_(handler), max_batch_(max_batch) {}
+
+    // Runs until the buffer is shut down and drained
+    void run(Buffer<T>& buffer) {
+        handler_.on_start();
+        std::vector<T> batch;
+        int64_t sequence = 0;
+        while (buffer.pop_batch(batch, max_batch_) > 0) {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                handler_.on_event(batch[i], sequence++, i + 1 == batch.size());
+            }
+            events_ += batch.size();
+            batches_++;
+            batch.clear();
+        }
+        handler_.on_shutdown();
+    }
+
+    // Runs until the ring is shut down and this reader has caught up
+    void run(BroadcastReader<T>& reader) {
+        handler_.on_start();
+        for (;;) {
+            size_t count = reader.consume_batch([this](const T& item, int64_t sequence, bool end_of_batch) {
+                handler_.on_event(item, sequence, end_of_batch);
+            });
+            if (count == 0) {
+                break;
+            }
+            events_ += count;
+            batches_++;
+        }
+        handler_.on_shutdown();
+    }
+
+    uint64_t batches() const { return batches_; }
+    uint64_t events() const { return events_; }
+};
+
+#endif // PRODUCER_CONSUMER_BATCH_HANDLER_H
@@ -0,0 +1,141 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "batch_handler.h"
+#include "broadcast_ring.h"
+#include "buffer.h"
+
+/**
+ * Batch Handler Demo
+ *
+ * A consumer writes every message to a file descriptor (/dev/null, so the
+ * cost measured is the write() syscall itself). The same messages are sent
+ * three ways:
+ * - Per message: a plain consumer loop calls write() for every item
+ * - Buffer + EventHandler: lines are collected and written once per batch,
+ *   when end_of_batch is set
+ * - BroadcastRing + EventHandler: same handler, reading the ring in place
+ */
+
+const int NUM_MESSAGES = 200000;
+
+struct Message {
+    int64_t id = 0;
+    char text[24] = {};
+};
+
+void fill(Message& message, int64_t id) {
+    message.id = id;
+    std::snprintf(message.text, sizeof(message.text), "order-%lld\n", static_cast<long long>(id));
+}
+
+// Appends each line and flushes with one write() when the batch ends
+class BatchWriter : public EventHandler<Message> {
+private:
+    int fd_;
+    std::string pending_;
+    uint64_t writes_ = 0;
+    uint64_t bytes_ = 0;
+
+public:
+    explicit BatchWriter(int fd) : fd_(fd) {}
+
+    void on_event(const Message& message, int64_t, bool end_of_batch) override {
+        pending_ += message.text;
+        if (end_of_batch) {
+            bytes_ += static_cast<uint64_t>(::write(fd_, pending_.data(), pending_.size()));
+            writes_++;
+            pending_.clear();
+        }
+    }
+
+    uint64_t writes() const { return writes_; }
+    uint64_t bytes() const { return bytes_; }
+};
+
+void report(const char* label, std::chrono::steady_clock::time_point start, uint64_t writes, uint64_t batches) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << label << " " << us.count() / 1000.0 << " ms, " << writes << " write() calls";
+    if (batches > 0) {
+        std::cout << ", avg batch " << static_cast<double>(NUM_MESSAGES) / static_cast<double>(batches);
+    }
+    std::cout << "\n";
+}
+
+int main() {
+    std::cout << "\n=== BATCH HANDLER DEMO ===\n";
+    std::cout << NUM_MESSAGES << " messages, one producer, one consumer writing to /dev/null\n\n";
+
+    int fd = ::open("/dev/null", O_WRONLY);
+    if (fd < 0) {
+        std::cerr << "[MAIN] cannot open /dev/null\n";
+        return 1;
+    }
+
+    // ---- One write() per message ----
+    {
+        Buffer<Message> buffer(1024);
+        uint64_t writes = 0;
+        auto start = std::chrono::steady_clock::now();
+        std::thread consumer([&] {
+            Message message;
+            while (buffer.pop(message)) {
+                ::write(fd, message.text, std::char_traits<char>::length(message.text));
+                writes++;
+            }
+        });
+        for (int64_t id = 0; id < NUM_MESSAGES; ++id) {
+            Message message;
+            fill(message, id);
+            buffer.push(message);
+        }
+        buffer.shutdown();
+        consumer.join();
+        report("[PER MESSAGE]  ", start, writes, 0);
+    }
+
+    // ---- Buffer drained in batches ----
+    {
+        Buffer<Message> buffer(1024);
+        BatchWriter writer(fd);
+        BatchEventProcessor<Message> processor(writer);
+        auto start = std::chrono::steady_clock::now();
+        std::thread consumer([&] { processor.run(buffer); });
+        for (int64_t id = 0; id < NUM_MESSAGES; ++id) {
+            Message message;
+            fill(message, id);
+            buffer.push(message);
+        }
+        buffer.shutdown();
+        consumer.join();
+        report("[BUFFER BATCH] ", start, writer.writes(), processor.batches());
+    }
+
+    // ---- Broadcast ring reader in batches ----
+    {
+        BroadcastRing<Message> ring(1024);
+        BroadcastReader<Message> reader = ring.add_reader();
+        BatchWriter writer(fd);
+        BatchEventProcessor<Message> processor(writer);
+        auto start = std::chrono::steady_clock::now();
+        std::thread consumer([&] { processor.run(reader); });
+        for (int64_t id = 0; id < NUM_MESSAGES; ++id) {
+            ring.publish_with([id](Message& message) { fill(message, id); });
+        }
+        ring.shutdown();
+        consumer.join();
+        report("[RING BATCH]   ", start, writer.writes(), processor.batches());
+        std::cout << "[MAIN] events handled: " << processor.events() << "\n";
+    }
+
+    ::close(fd);
+    std::cout << "\n=== BATCH HANDLER DEMO COMPLETED ===\n\n";
+    return 0;
+}
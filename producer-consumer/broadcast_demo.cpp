@@ -0,0 +1,118 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "broadcast_ring.h"
+#include "buffer.h"
+
+/**
+ * Broadcast Ring Demo
+ *
+ * Three consumers (audit, metrics, processing) each need every message.
+ * The demo sends the same 500000 events both ways and compares:
+ * - One Buffer per consumer: the producer pushes every event 3 times
+ * - One BroadcastRing: the producer writes every event once and all three
+ *   readers read it in place
+ */
+
+struct Event {
+    int64_t id = 0;
+    int64_t amount = 0;
+    char account[24] = {};
+};
+
+const int64_t NUM_EVENTS = 500000;
+const char* READER_NAMES[] = {"audit", "metrics", "processing"};
+
+void fill(Event& event, int64_t id) {
+    event.id = id;
+    event.amount = id % 1000;
+    event.account[0] = static_cast<char>('A' + id % 26);
+}
+
+int main() {
+    std::cout << "\n=== BROADCAST RING DEMO ===\n";
+    std::cout << NUM_EVENTS << " events, 3 consumers that each need every event\n\n";
+
+    // ---- N separate buffers, N copies ----
+    {
+        std::vector<std::unique_ptr<Buffer<Event>>> buffers;
+        std::vector<std::thread> consumers;
+        std::vector<int64_t> totals(3, 0);
+        for (int i = 0; i < 3; ++i) {
+            buffers.push_back(std::make_unique<Buffer<Event>>(1024));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 3; ++i) {
+            consumers.emplace_back([&, i] {
+                Event event;
+                while (buffers[i]->pop(event)) {
+                    totals[i] += event.amount;
+                }
+            });
+        }
+        for (int64_t id = 0; id < NUM_EVENTS; ++id) {
+            Event event;
+            fill(event, id);
+            for (auto& buffer : buffers) {
+                buffer->push(event);            // One copy per consumer
+            }
+        }
+        for (auto& buffer : buffers) {
+            buffer->shutdown();
+        }
+        for (auto& consumer : consumers) {
+            consumer.join();
+        }
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        std::cout << "[3 BUFFERS] " << ms.count() << " ms, " << NUM_EVENTS * 3 << " pushes |";
+        for (int i = 0; i < 3; ++i) {
+            std::cout << " " << READER_NAMES[i] << "=" << totals[i];
+        }
+        std::cout << "\n";
+    }
+
+    // ---- One broadcast ring, zero copies ----
+    {
+        BroadcastRing<Event> ring(1024);
+        std::vector<BroadcastReader<Event>> readers;
+        for (int i = 0; i < 3; ++i) {
+            readers.push_back(ring.add_reader());
+        }
+
+        std::vector<std::thread> consumers;
+        std::vector<int64_t> totals(3, 0);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 3; ++i) {
+            consumers.emplace_back([&, i] {
+                // Reads each event in place, by const reference
+                while (readers[i].consume([&](const Event& event, int64_t) { totals[i] += event.amount; }) > 0) {
+                }
+            });
+        }
+        for (int64_t id = 0; id < NUM_EVENTS; ++id) {
+            ring.publish_with([id](Event& event) { fill(event, id); });
+        }
+        ring.shutdown();
+        for (auto& consumer : consumers) {
+            consumer.join();
+        }
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        std::cout << "[BROADCAST] " << ms.count() << " ms, " << NUM_EVENTS << " writes |";
+        for (int i = 0; i < 3; ++i) {
+            std::cout << " " << READER_NAMES[i] << "=" << totals[i];
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "\n=== BROADCAST RING DEMO COMPLETED ===\n\n";
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+#ifndef PRODUCER_CONSUMER_BROADCAST_RING_H
+#define PRODUCER_CONSUMER_BROADCAST_RING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "atomics.h"
+#include "backoff.h"
+
+/**
+ * Broadcast (Fan-Out) Ring
+ *
+ * Buffer delivers each message to exactly one consumer. When several
+ * consumers (audit, metrics, processing) each need every message, the
+ * usual fix is one Buffer per consumer, i.e. N pushes and N copies.
+ *
+ * BroadcastRing follows the LMAX Disruptor design instead:
+ * - One preallocated ring, written by a single producer
+ * - The producer publishes by advancing one cursor (a release store)
+ * - Every reader has its own sequence cursor and reads entries in place,
+ *   by const reference, so fan-out costs one write and zero copies
+ * - The producer may only reuse a slot once the slowest reader has moved
+ *   past it (that is the backpressure)
+ *
+ * Readers can also depend on other readers (a sequence barrier): a reader
+ * added with add_reader({&a, &b}) only sees entry N once readers a and b
+ * are done with it. This lets a diamond of stages (e.g. journal and
+ * replicate in parallel, then business logic) share one ring with no
+ * intermediate queues. Stages hand results downstream by writing their own
+ * fields of the entry with update(); a field must only be written by one
+ * stage, and only read by stages that depend on it. The producer is gated
+ * on the last stages only, since everything upstream is necessarily ahead.
+ *
+ * Sequences start at -1 and only grow; slot = sequence & (capacity - 1).
+ * Readers must all be added before the producer starts publishing.
+ * Waiting spins, then yields (see backoff.h).
+ */
+
+// A padded cursor, so two cursors never share a cache line
+class alignas(64) Sequence {
+private:
+    Atomic<int64_t> value_;
+
+public:
+    static constexpr int64_t INITIAL = -1;
+
+    explicit Sequence(int64_t initial = INITIAL) : value_(initial) {}
+
+    int64_t get() const { return value_.load(std::memory_order_acquire); }
+    void set(int64_t value) { value_.store(value, std::memory_order_release); }
+};
+
+// Tells a reader how far it may go: the producer cursor, limited by the
+// cursors of every reader it depends on
+class SequenceBarrier {
+private:
+    const Sequence* cursor_;
+    std::vector<const Sequence*> dependencies_;
+    const Atomic<bool>* shutdown_;
+
+    int64_t available() const {
+        int64_t minimum = cursor_->get();
+        for (const Sequence* dependency : dependencies_) {
+            minimum = std::min(minimum, dependency->get());
+        }
+        return minimum;
+    }
+
+public:
+    SequenceBarrier(const Sequence* cursor, std::vector<const Sequence*> dependencies,
+                    const Atomic<bool>* shutdown)
+        : cursor_(cursor), dependencies_(std::move(dependencies)), shutdown_(shutdown) {}
+
+    // Highest sequence >= `sequence` that may be read, or less than `sequence`
+    // once the ring is shut down and every upstream reader has finished
+    int64_t wait_for(int64_t sequence) const {
+        Backoff backoff;
+        for (;;) {
+            int64_t limit = available();
+            if (limit >= sequence) {
+                return limit;
+            }
+            // Upstream readers may still be catching up after shutdown
+            if (shutdown_->load(std::memory_order_acquire) && limit == cursor_->get()) {
+                return limit;
+            }
+            backoff.pause();
+        }
+    }
+};
+
+template<typename T>
+class BroadcastRing;
+
+// One reader's view of the ring
+template<typename T>
+class BroadcastReader {
+private:
+    BroadcastRing<T>* ring_;
+    Sequence* sequence_;
+    SequenceBarrier barrier_;
+
+    friend class BroadcastRing<T>;
+
+    BroadcastReader(BroadcastRing<T>* ring, Sequence* sequence, SequenceBarrier barrier)
+        : ring_(ring), sequence_(sequence), barrier_(std::move(barrier)) {}
+
+    // fn(entry, sequence, last) where last is the final sequence of this pass
+    template<typename Entry, typename F>
+    size_t run(F&& fn) {
+        int64_t next = sequence_->get() + 1;
+        int64_t available = barrier_.wait_for(next);
+        if (available < next) {
+            return 0;
+        }
+        for (int64_t sequence = next; sequence <= available; ++sequence) {
+            Entry& entry = ring_->entry(sequence);
+            PC_MODEL_ACCESS(&entry, !std::is_const<Entry>::value);     // update() writes
+            fn(entry, sequence, available);
+        }
+        sequence_->set(available);
+        return static_cast<size_t>(available - next + 1);
+    }
+
+public:
+    // Waits for new entries and calls fn(entry, sequence) for every entry
+    // available at that moment, then releases them all at once. Returns the
+    // number processed; 0 means the ring is shut down and fully read.
+    template<typename F>
+    size_t consume(F&& fn) {
+        return run<const T>([&fn](const T& entry, int64_t sequence, int64_t) { fn(entry, sequence); });
+    }
+
+    // Same as consume(), but fn(entry, sequence, end_of_batch) is also told
+    // which entry is the last one of this pass (see batch_handler.h)
+    template<typename F>
+    size_t consume_batch(F&& fn) {
+        return run<const T>([&fn](const T& entry, int64_t sequence, int64_t last) {
+            fn(entry, sequence, sequence == last);
+        });
+    }
+
+    // Same as consume(), but fn gets a mutable entry so a pipeline stage can
+    // fill in its own fields for the stages that depend on it
+    template<typename F>
+    size_t update(F&& fn) {
+        return run<T>([&fn](T& entry, int64_t sequence, int64_t) { fn(entry, sequence); });
+    }
+
+    int64_t position() const { return sequence_->get(); }
+};
+
+template<typename T>
+class BroadcastRing {
+private:
+    std::vector<T> entries_;
+    const int64_t mask_;
+    Sequence cursor_;                                   // Last published sequence
+    std::vector<std::unique_ptr<Sequence>> readers_;
+    std::vector<const Sequence*> gating_;               // Readers nobody depends on
+    int64_t next_ = 0;                                  // Producer-local: next sequence to claim
+    int64_t cached_gate_ = Sequence::INITIAL;           // Producer-local: last seen slowest reader
+    Atomic<bool> shutdown_{false};
+
+    friend class BroadcastReader<T>;
+
+    static size_t round_up_pow2(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    T& entry(int64_t sequence) { return entries_[static_cast<size_t>(sequence & mask_)]; }
+
+    int64_t slowest_reader() const {
+        int64_t minimum = std::numeric_limits<int64_t>::max();
+        for (const Sequence* reader : gating_) {
+            minimum = std::min(minimum, reader->get());
+        }
+        return gating_.empty() ? cursor_.get() : minimum;
+    }
+
+public:
+    explicit BroadcastRing(size_t capacity = 1024)
+        : entries_(round_up_pow2(capacity)), mask_(static_cast<int64_t>(entries_.size()) - 1) {}
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    // Registers a reader that starts at the next published entry and only
+    // sees an entry once every reader in `after` has processed it
+    BroadcastReader<T> add_reader(std::initializer_list<const BroadcastReader<T>*> after = {}) {
+        std::vector<const Sequence*> dependencies;
+        for (const BroadcastReader<T>* upstream : after) {
+            dependencies.push_back(upstream->sequence_);
+            // The new reader is behind its upstream, so the producer only needs to watch it
+            gating_.erase(std::remove(gating_.begin(), gating_.end(), upstream->sequence_), gating_.end());
+        }
+
+        readers_.push_back(std::make_unique<Sequence>(cursor_.get()));
+        gating_.push_back(readers_.back().get());
+        return BroadcastReader<T>(this, readers_.back().get(),
+                                  SequenceBarrier(&cursor_, std::move(dependencies), &shutdown_));
+    }
+
+    // Single producer only. fill(entry) writes the next entry in place;
+    // blocks while the slowest reader is a full lap behind.
+    template<typename Fill>
+    void publish_with(Fill&& fill) {
+        int64_t sequence = next_++;
+        int64_t wrap_point = sequence - static_cast<int64_t>(entries_.size());
+        if (wrap_point > cached_gate_) {
+            Backoff backoff;
+            while (wrap_point > (cached_gate_ = slowest_reader())) {
+                backoff.pause();
+            }
+        }
+        PC_MODEL_WRITE(&entry(sequence));
+        fill(entry(sequence));
+        cursor_.set(sequence);
+    }
+
+    void publish(const T& item) {
+        publish_with([&item](T& entry) { entry = item; });
+    }
+
+    // Readers finish what is published and then stop
+    void shutdown() { shutdown_.store(true, std::memory_order_release); }
+
+    int64_t cursor() const { return cursor_.get(); }
+    size_t capacity() const { return entries_.size(); }
+};
+
+#endif // PRODUCER_CONSUMER_BROADCAST_RING_H
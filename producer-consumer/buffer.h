@@ -0,0 +1,244 @@
+#ifndef PRODUCER_CONSUMER_BUFFER_H
+#define PRODUCER_CONSUMER_BUFFER_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "lock_profiler.h"
+#include "overflow_policy.h"
+#include "select_waiter.h"
+#include "trace.h"
+
+/**
+ * Reusable Bounded Buffer
+ *
+ * The same mutex + two condition variable design as the Buffer in
+ * multi_producer_consumer.cpp, turned into a template so that other
+ * demos can chain several buffers together. It does not print anything,
+ * so it can sit on a hot path.
+ *
+ * Shutdown semantics:
+ * - push() returns false once shutdown() has been called (item is dropped)
+ * - pop() keeps returning remaining items and only returns false once the
+ *   buffer is both shut down AND empty, so consumers always drain it
+ *
+ * When full, push() blocks by default. A lossy OverflowPolicy can be chosen
+ * instead (see overflow_policy.h); dropped items are counted in dropped().
+ *
+ * Built with PRODUCER_CONSUMER_TRACE, push/pop and any blocking waits are
+ * recorded on the calling thread's timeline (see trace.h). Built with
+ * PRODUCER_CONSUMER_LOCK_PROFILE, the mutex records contention, wait and
+ * hold times per method (see lock_profiler.h).
+ *
+ * A Select (see select.h) that watches this buffer registers its waiter
+ * here; push() and shutdown() wake it along with the condition variables.
+ */
+#ifdef PRODUCER_CONSUMER_LOCK_PROFILE
+using BufferMutex = ProfiledMutex;
+using BufferCondition = std::condition_variable_any;
+#else
+using BufferMutex = std::mutex;
+using BufferCondition = std::condition_variable;
+#endif
+
+template<typename T>
+class Buffer {
+private:
+    std::queue<T> data_;
+    mutable BufferMutex mutex_;
+    BufferCondition not_empty_;             // Consumers wait here
+    BufferCondition not_full_;              // Producers wait here
+    const size_t capacity_;
+    const OverflowPolicy policy_;
+    const size_t sample_every_;
+    bool shutdown_ = false;                 // Protected by mutex_
+    DropCounts dropped_;                    // Protected by mutex_
+    uint64_t overflows_ = 0;                // Protected by mutex_
+    std::vector<SelectWaiter*> waiters_;    // Protected by mutex_
+
+    // Under mutex_, so a waiter cannot be removed (and destroyed) mid-notify
+    void notify_waiters() {
+        for (SelectWaiter* waiter : waiters_) {
+            waiter->notify();
+        }
+    }
+
+    // The trace only shows a wait when the caller really blocks
+    void wait_not_full(std::unique_lock<BufferMutex>& lock) {
+        auto ready = [this] { return data_.size() < capacity_ || shutdown_; };
+        if (!ready()) {
+            PC_TRACE_SCOPE("wait not_full");
+            not_full_.wait(lock, ready);
+        }
+    }
+
+    void wait_not_empty(std::unique_lock<BufferMutex>& lock) {
+        auto ready = [this] { return !data_.empty() || shutdown_; };
+        if (!ready()) {
+            PC_TRACE_SCOPE("wait not_empty");
+            not_empty_.wait(lock, ready);
+        }
+    }
+
+public:
+    explicit Buffer(size_t capacity = 10, OverflowPolicy policy = OverflowPolicy::Block,
+                    size_t sample_every = 4)
+        : capacity_(capacity), policy_(policy), sample_every_(sample_every) {}
+
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    // Blocks while the buffer is full (this is the backpressure), unless a
+    // lossy overflow policy was chosen. Returns true if the item was queued.
+    bool push(T item) {
+        return push(std::move(item), [](T&) {});
+    }
+
+    // Same as push(), but calls on_enqueue(item) under the lock right before
+    // the item becomes visible to consumers (see latency_trace.h)
+    template<typename OnEnqueue>
+    bool push(T item, OnEnqueue on_enqueue) {
+        PC_TRACE_SCOPE("push");
+        PC_LOCK_SITE("Buffer::push");
+        std::unique_lock<BufferMutex> lock(mutex_);
+        if (policy_ == OverflowPolicy::Block) {
+            wait_not_full(lock);
+        }
+
+        if (shutdown_) {
+            return false;
+        }
+
+        if (data_.size() >= capacity_) {
+            bool keep = policy_ == OverflowPolicy::DropOldest ||
+                        (policy_ == OverflowPolicy::Sample && sample_keeps(++overflows_, sample_every_));
+            if (!keep) {
+                dropped_.newest++;
+                return false;
+            }
+            data_.pop();
+            dropped_.oldest++;
+        }
+
+        on_enqueue(item);
+        data_.push(std::move(item));
+        notify_waiters();
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Blocks until an item is available or the buffer is shut down and drained
+    bool pop(T& item) {
+        PC_TRACE_SCOPE("pop");
+        PC_LOCK_SITE("Buffer::pop");
+        std::unique_lock<BufferMutex> lock(mutex_);
+        wait_not_empty(lock);
+
+        if (data_.empty()) {
+            return false;
+        }
+
+        item = std::move(data_.front());
+        data_.pop();
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    bool try_pop(T& item) {
+        PC_LOCK_SITE("Buffer::try_pop");
+        std::unique_lock<BufferMutex> lock(mutex_);
+        if (data_.empty()) {
+            return false;
+        }
+
+        item = std::move(data_.front());
+        data_.pop();
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // Blocks like pop(), then moves everything available (up to max_items)
+    // into `out` under a single lock. Returns the number of items taken;
+    // 0 means shut down and drained.
+    size_t pop_batch(std::vector<T>& out, size_t max_items = SIZE_MAX) {
+        PC_TRACE_SCOPE("pop_batch");
+        PC_LOCK_SITE("Buffer::pop_batch");
+        std::unique_lock<BufferMutex> lock(mutex_);
+        wait_not_empty(lock);
+
+        size_t taken = 0;
+        while (!data_.empty() && taken < max_items) {
+            out.push_back(std::move(data_.front()));
+            data_.pop();
+            taken++;
+        }
+        lock.unlock();
+        if (taken > 0) {
+            not_full_.notify_all();         // Several slots may have freed up
+        }
+        return taken;
+    }
+
+    void shutdown() {
+        PC_LOCK_SITE("Buffer::shutdown");
+        {
+            std::lock_guard<BufferMutex> lock(mutex_);
+            shutdown_ = true;
+            notify_waiters();
+        }
+        // Wake up ALL waiting threads
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    // The waiter is notified after every push and on shutdown until removed
+    void add_waiter(SelectWaiter* waiter) {
+        PC_LOCK_SITE("Buffer::add_waiter");
+        std::lock_guard<BufferMutex> lock(mutex_);
+        waiters_.push_back(waiter);
+    }
+
+    void remove_waiter(SelectWaiter* waiter) {
+        PC_LOCK_SITE("Buffer::remove_waiter");
+        std::lock_guard<BufferMutex> lock(mutex_);
+        waiters_.erase(std::remove(waiters_.begin(), waiters_.end(), waiter), waiters_.end());
+    }
+
+    bool is_shutdown() const {
+        PC_LOCK_SITE("Buffer::is_shutdown");
+        std::lock_guard<BufferMutex> lock(mutex_);
+        return shutdown_;
+    }
+
+    DropCounts dropped() const {
+        PC_LOCK_SITE("Buffer::dropped");
+        std::lock_guard<BufferMutex> lock(mutex_);
+        return dropped_;
+    }
+
+    OverflowPolicy policy() const { return policy_; }
+    size_t capacity() const { return capacity_; }
+
+    size_t size() const {
+        PC_LOCK_SITE("Buffer::size");
+        std::lock_guard<BufferMutex> lock(mutex_);
+        return data_.size();
+    }
+
+    bool empty() const {
+        PC_LOCK_SITE("Buffer::empty");
+        std::lock_guard<BufferMutex> lock(mutex_);
+        return data_.empty();
+    }
+};
+
+#endif // PRODUCER_CONSUMER_BUFFER_H
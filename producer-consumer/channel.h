@@ -0,0 +1,249 @@
+#ifndef PRODUCER_CONSUMER_CHANNEL_H
+#define PRODUCER_CONSUMER_CHANNEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "buffer.h"
+#include "mpsc_queue.h"
+#include "ring_buffer.h"
+#include "spmc_ring.h"
+#include "spsc_ring.h"
+
+/**
+ * Compile-Time Channel Selection
+ *
+ * Every queue in this project has the same push/pop/try_pop/shutdown API,
+ * but they are not interchangeable: SpscRing is only correct with one
+ * thread on each side, MpscQueue with one consumer, and so on. Picking one
+ * by hand means remembering those rules and revisiting the choice whenever
+ * the thread counts change. Declare the topology instead:
+ *
+ *   auto channel = make_channel<std::string, 1, 1, 10>();   // SpscRing
+ *   auto channel = make_channel<Job, 4, 2, 64>();            // RingBuffer
+ *
+ * make_channel<T, Producers, Consumers, Capacity>() resolves the cheapest
+ * backend that is correct for that topology at compile time (if constexpr,
+ * so only the chosen queue is instantiated):
+ *
+ *   Producers  Consumers  Bounded (Capacity > 0)   Unbounded (Capacity 0)
+ *   1          1          SpscRing                 MpscQueue
+ *   1          many       SpmcRing                 Buffer
+ *   many       1          RingBuffer               MpscQueue
+ *   many       many       RingBuffer               Buffer
+ *
+ * Bounded MPSC uses RingBuffer: MpscQueue cannot refuse a push, and bounding
+ * it would need the same CAS on a shared counter that RingBuffer already
+ * does. Lock-free backends round the capacity up to a power of two and wait
+ * by spinning (see backoff.h); the unbounded multi-consumer case falls back
+ * to Buffer, whose consumers sleep on a condition variable.
+ *
+ * The counts are a contract: a channel made for one producer must only be
+ * pushed to from one thread at a time. ChannelBackend<...> names the
+ * selected type for members and parameters.
+ *
+ * The lock-free backends are chosen for throughput: a thread blocked on a
+ * full or empty ring spins and yields instead of sleeping. Where threads
+ * mostly wait (slow producers, long processing), a Buffer is cheaper.
+ *
+ * Sender / Receiver Handles
+ *
+ * With a bare queue, someone has to know when every producer is done and
+ * call shutdown(), typically main() after a shared `running` flag. Instead,
+ * open_channel() splits the channel into handles, as in Go and Rust:
+ *
+ *   auto [sender, receiver] = open_channel<Job, 4, 2, 64>();
+ *   for (...) producers.emplace_back(produce, sender);     // copy = clone
+ *   for (...) consumers.emplace_back(consume, receiver);
+ *   sender.close();                                        // main sends nothing
+ *   ...
+ *   while (receiver.recv(job)) { ... }                     // ends once closed and drained
+ *
+ * Copying a handle clones it; handles of each kind are reference-counted.
+ * When the last Sender is closed or destroyed the channel shuts down, so
+ * receivers drain what is left and then recv() returns false. When the
+ * last Receiver goes away it also shuts down, so send() returns false
+ * instead of blocking forever on a channel nobody reads. Moving a handle
+ * does not change the counts. open_channel_over<T>(make) gives the same
+ * handles over a queue built by make(), e.g. a Buffer whose waiters sleep.
+ */
+
+enum class ChannelKind {
+    SPSC,           // SpscRing
+    SPMC,           // SpmcRing
+    MPSC,           // MpscQueue (unbounded)
+    MPMC,           // RingBuffer
+    LOCKED          // Buffer (unbounded, many consumers)
+};
+
+constexpr size_t UNBOUNDED = 0;
+
+constexpr ChannelKind select_channel(size_t producers, size_t consumers, size_t capacity) {
+    if (capacity == UNBOUNDED) {
+        return consumers == 1 ? ChannelKind::MPSC : ChannelKind::LOCKED;
+    }
+    if (producers == 1) {
+        return consumers == 1 ? ChannelKind::SPSC : ChannelKind::SPMC;
+    }
+    return ChannelKind::MPMC;
+}
+
+constexpr const char* channel_kind_name(ChannelKind kind) {
+    switch (kind) {
+        case ChannelKind::SPSC:
+            return "SpscRing";
+        case ChannelKind::SPMC:
+            return "SpmcRing";
+        case ChannelKind::MPSC:
+            return "MpscQueue";
+        case ChannelKind::MPMC:
+            return "RingBuffer";
+        case ChannelKind::LOCKED:
+            return "Buffer";
+    }
+    return "unknown";
+}
+
+template<typename T, size_t Producers, size_t Consumers, size_t Capacity = 1024>
+auto make_channel() {
+    static_assert(Producers > 0 && Consumers > 0, "a channel needs at least one producer and one consumer");
+    constexpr ChannelKind kind = select_channel(Producers, Consumers, Capacity);
+
+    // Queues are not movable; C++17 guaranteed copy elision still lets us return them
+    if constexpr (kind == ChannelKind::SPSC) {
+        return SpscRing<T>(Capacity);
+    } else if constexpr (kind == ChannelKind::SPMC) {
+        return SpmcRing<T>(Capacity);
+    } else if constexpr (kind == ChannelKind::MPSC) {
+        return MpscQueue<T>();
+    } else if constexpr (kind == ChannelKind::MPMC) {
+        return RingBuffer<T>(Capacity);
+    } else {
+        return Buffer<T>(SIZE_MAX);
+    }
+}
+
+template<typename T, size_t Producers, size_t Consumers, size_t Capacity = 1024>
+using ChannelBackend = decltype(make_channel<T, Producers, Consumers, Capacity>());
+
+// Shared by all handles of one channel
+template<typename Queue>
+struct ChannelState {
+    Queue queue;
+    std::atomic<size_t> senders{0};
+    std::atomic<size_t> receivers{0};
+
+    template<typename Make>
+    explicit ChannelState(Make make) : queue(make()) {}
+};
+
+template<typename T, typename Queue>
+class Sender {
+private:
+    std::shared_ptr<ChannelState<Queue>> state_;
+
+public:
+    explicit Sender(std::shared_ptr<ChannelState<Queue>> state) : state_(std::move(state)) {
+        state_->senders.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Clone
+    Sender(const Sender& other) : state_(other.state_) {
+        if (state_) {
+            state_->senders.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    Sender(Sender&& other) noexcept = default;
+
+    Sender& operator=(Sender other) noexcept {
+        std::swap(state_, other.state_);    // other closes our old handle
+        return *this;
+    }
+
+    ~Sender() { close(); }
+
+    // Drops this handle; the last one shuts the channel down
+    void close() {
+        if (state_ && state_->senders.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            state_->queue.shutdown();
+        }
+        state_.reset();
+    }
+
+    // Blocks while the channel is full. Returns false once it is closed.
+    bool send(T item) { return state_ && state_->queue.push(std::move(item)); }
+
+    bool is_closed() const { return !state_ || state_->queue.is_shutdown(); }
+};
+
+template<typename T, typename Queue>
+class Receiver {
+private:
+    std::shared_ptr<ChannelState<Queue>> state_;
+
+public:
+    explicit Receiver(std::shared_ptr<ChannelState<Queue>> state) : state_(std::move(state)) {
+        state_->receivers.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Clone
+    Receiver(const Receiver& other) : state_(other.state_) {
+        if (state_) {
+            state_->receivers.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    Receiver(Receiver&& other) noexcept = default;
+
+    Receiver& operator=(Receiver other) noexcept {
+        std::swap(state_, other.state_);
+        return *this;
+    }
+
+    ~Receiver() { close(); }
+
+    // Drops this handle; the last one shuts the channel down, so senders stop
+    void close() {
+        if (state_ && state_->receivers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            state_->queue.shutdown();
+        }
+        state_.reset();
+    }
+
+    // Blocks until an item arrives. Returns false once every sender is gone
+    // and everything they sent has been received.
+    bool recv(T& item) { return state_ && state_->queue.pop(item); }
+
+    bool try_recv(T& item) { return state_ && state_->queue.try_pop(item); }
+
+    bool is_closed() const { return !state_ || state_->queue.is_shutdown(); }
+
+    // Approximate while senders are active
+    bool empty() const { return !state_ || state_->queue.empty(); }
+};
+
+template<typename T, size_t Producers, size_t Consumers, size_t Capacity = 1024>
+using ChannelSender = Sender<T, ChannelBackend<T, Producers, Consumers, Capacity>>;
+
+template<typename T, size_t Producers, size_t Consumers, size_t Capacity = 1024>
+using ChannelReceiver = Receiver<T, ChannelBackend<T, Producers, Consumers, Capacity>>;
+
+// The queue make() returns, as one Sender and one Receiver
+template<typename T, typename Make, typename Queue = decltype(std::declval<Make>()())>
+std::pair<Sender<T, Queue>, Receiver<T, Queue>> open_channel_over(Make make) {
+    auto state = std::make_shared<ChannelState<Queue>>(std::move(make));
+    return {Sender<T, Queue>(state), Receiver<T, Queue>(std::move(state))};
+}
+
+// A channel with the backend make_channel() selects, as one Sender and one Receiver
+template<typename T, size_t Producers, size_t Consumers, size_t Capacity = 1024>
+std::pair<ChannelSender<T, Producers, Consumers, Capacity>, ChannelReceiver<T, Producers, Consumers, Capacity>>
+open_channel() {
+    return open_channel_over<T>([] { return make_channel<T, Producers, Consumers, Capacity>(); });
+}
+
+#endif // PRODUCER_CONSUMER_CHANNEL_H
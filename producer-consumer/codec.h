@@ -0,0 +1,37 @@
+#ifndef PRODUCER_CONSUMER_CODEC_H
+#define PRODUCER_CONSUMER_CODEC_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+/**
+ * Item Serialization for On-Disk Buffers
+ *
+ * SpillBuffer and DurableBuffer write items to files, so they need a byte
+ * representation. ItemCodec<T> is provided for std::string and for
+ * trivially copyable types; specialize it for anything else:
+ * - size(item):           number of bytes encode() will write
+ * - encode(item, out):    writes exactly size(item) bytes
+ * - decode(in, size, item)
+ */
+
+template<typename T, typename Enable = void>
+struct ItemCodec;
+
+template<typename T>
+struct ItemCodec<T, std::enable_if_t<std::is_trivially_copyable<T>::value>> {
+    static size_t size(const T&) { return sizeof(T); }
+    static void encode(const T& item, char* out) { std::memcpy(out, &item, sizeof(T)); }
+    static void decode(const char* in, size_t, T& item) { std::memcpy(&item, in, sizeof(T)); }
+};
+
+template<>
+struct ItemCodec<std::string> {
+    static size_t size(const std::string& item) { return item.size(); }
+    static void encode(const std::string& item, char* out) { std::memcpy(out, item.data(), item.size()); }
+    static void decode(const char* in, size_t size, std::string& item) { item.assign(in, size); }
+};
+
+#endif // PRODUCER_CONSUMER_CODEC_H
@@ -0,0 +1,152 @@
+#ifndef PRODUCER_CONSUMER_CONFLATING_BUFFER_H
+#define PRODUCER_CONSUMER_CONFLATING_BUFFER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Conflating (Coalescing) Buffer
+ *
+ * Many messages supersede earlier ones with the same key (latest price,
+ * latest state). ConflatingBuffer::push(key, value) therefore replaces the
+ * value of a not-yet-consumed entry for that key in place instead of
+ * queueing a second one:
+ * - Entries live in a fixed ring of slots, in order of their key's first
+ *   pending update, so FIFO fairness between keys is preserved
+ * - A hash index maps each pending key to its slot, so a replace is O(1)
+ * - A slow consumer only ever sees the latest value per key, and the queue
+ *   depth is bounded by the number of distinct keys, not the message rate
+ *
+ * push() only blocks when `capacity` different keys are pending at once.
+ */
+template<typename K, typename V>
+class ConflatingBuffer {
+private:
+    struct Slot {
+        K key;
+        V value;
+        uint64_t updates = 0;   // How many pushes this slot absorbed
+    };
+
+    std::vector<Slot> slots_;
+    std::unordered_map<K, size_t> index_;   // Pending key -> slot index
+    size_t head_ = 0;                       // Oldest pending slot
+    size_t count_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    bool shutdown_ = false;
+    uint64_t conflated_ = 0;
+
+public:
+    // A capacity of 0 is raised to 1: the slot ring needs at least one slot
+    explicit ConflatingBuffer(size_t capacity = 64) : slots_(capacity < 1 ? 1 : capacity) {
+        index_.reserve(slots_.size());
+    }
+
+    ConflatingBuffer(const ConflatingBuffer&) = delete;
+    ConflatingBuffer& operator=(const ConflatingBuffer&) = delete;
+
+    // Returns false after shutdown()
+    bool push(const K& key, V value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (shutdown_) {
+            return false;
+        }
+
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            // Key already pending: overwrite in place, no new slot, no wakeup needed
+            Slot& slot = slots_[it->second];
+            slot.value = std::move(value);
+            slot.updates++;
+            conflated_++;
+            return true;
+        }
+
+        not_full_.wait(lock, [this] { return count_ < slots_.size() || shutdown_; });
+        if (shutdown_) {
+            return false;
+        }
+
+        // A concurrent push for the same key may have claimed a slot while we waited
+        it = index_.find(key);
+        if (it != index_.end()) {
+            slots_[it->second].value = std::move(value);
+            slots_[it->second].updates++;
+            conflated_++;
+            return true;
+        }
+
+        size_t position = (head_ + count_) % slots_.size();
+        Slot& slot = slots_[position];
+        slot.key = key;
+        slot.value = std::move(value);
+        slot.updates = 1;
+        index_.emplace(key, position);
+        count_++;
+
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Blocks until an entry is available or the buffer is shut down and drained.
+    // `updates` (optional) receives how many pushes were coalesced into the entry.
+    bool pop(K& key, V& value, uint64_t* updates = nullptr) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return count_ > 0 || shutdown_; });
+
+        if (count_ == 0) {
+            return false;
+        }
+
+        Slot& slot = slots_[head_];
+        index_.erase(slot.key);
+        key = std::move(slot.key);
+        value = std::move(slot.value);
+        if (updates) {
+            *updates = slot.updates;
+        }
+        head_ = (head_ + 1) % slots_.size();
+        count_--;
+
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    // Number of pushes that replaced a pending value instead of adding an entry
+    uint64_t conflated() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return conflated_;
+    }
+
+    size_t capacity() const { return slots_.size(); }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+
+    bool empty() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_ == 0;
+    }
+};
+
+#endif // PRODUCER_CONSUMER_CONFLATING_BUFFER_H
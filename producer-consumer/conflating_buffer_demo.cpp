@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "conflating_buffer.h"
+
+/**
+ * Conflating Buffer Demo
+ *
+ * A market data producer publishes 2000 price updates for 5 symbols with
+ * no pause. The consumer needs 2ms per update, so a plain FIFO queue would
+ * either block the producer or grow to 2000 entries of mostly stale prices.
+ * With ConflatingBuffer the queue never holds more than 5 entries and the
+ * consumer always ends on the latest price of every symbol.
+ */
+
+int main() {
+    std::cout << "\n=== CONFLATING BUFFER DEMO ===\n";
+
+    const std::vector<std::string> SYMBOLS = {"AAPL", "MSFT", "GOOG", "AMZN", "NVDA"};
+    const int NUM_UPDATES = 2000;
+
+    ConflatingBuffer<std::string, double> prices(SYMBOLS.size());
+    std::map<std::string, double> published;
+    std::map<std::string, double> seen;
+    size_t max_depth = 0;
+    int processed = 0;
+
+    std::thread consumer([&] {
+        std::string symbol;
+        double price;
+        uint64_t updates;
+        while (prices.pop(symbol, price, &updates)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            seen[symbol] = price;
+            processed++;
+            if (processed % 10 == 0) {
+                std::cout << "[CONSUMER] " << symbol << " = " << std::fixed << std::setprecision(2) << price
+                          << " (coalesced " << updates << " updates)\n";
+            }
+        }
+    });
+
+    for (int i = 0; i < NUM_UPDATES; ++i) {
+        const std::string& symbol = SYMBOLS[i % SYMBOLS.size()];
+        double price = 100.0 + (i % 97) * 0.25;
+        published[symbol] = price;
+        prices.push(symbol, price);
+        max_depth = std::max(max_depth, prices.size());
+        if (i % 50 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    prices.shutdown();
+    consumer.join();
+
+    std::cout << "\n[MAIN] Published " << NUM_UPDATES << " updates, consumer processed " << processed
+              << ", conflated " << prices.conflated() << ", max depth " << max_depth << "\n";
+    for (const auto& symbol : SYMBOLS) {
+        std::cout << "[MAIN] " << symbol << ": latest published " << published[symbol] << ", consumer saw "
+                  << seen[symbol] << (published[symbol] == seen[symbol] ? " (up to date)" : " (STALE)")
+                  << "\n";
+    }
+    std::cout << "=== CONFLATING BUFFER DEMO COMPLETED ===\n\n";
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+#ifndef PRODUCER_CONSUMER_DELAY_BUFFER_H
+#define PRODUCER_CONSUMER_DELAY_BUFFER_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "buffer.h"
+#include "timer_wheel.h"
+
+/**
+ * Delayed Delivery Buffer
+ *
+ * "Deliver this in 200 ms" (retries with backoff, scheduled reminders,
+ * debounce) otherwise ends up as a producer sleeping before push(), or a
+ * consumer popping, checking a timestamp and re-queueing. DelayBuffer<T>
+ * puts a Buffer<T> behind a hierarchical timing wheel (see timer_wheel.h):
+ *
+ *   DelayBuffer<Task> buffer(64);
+ *   buffer.push(task);                                          // now
+ *   buffer.push_after(retry, std::chrono::milliseconds(200));   // later
+ *   buffer.pop(task);                                           // as usual
+ *
+ * - push_after()/push_at() are O(1) and never block; the item becomes
+ *   visible to pop() once it is due, never earlier, and at most about one
+ *   tick later (plus scheduling delay)
+ * - A single timer thread sleeps until the next wheel slot is due, then
+ *   moves everything that expired into the ready Buffer. Capacity and
+ *   backpressure apply to the ready Buffer only
+ * - After shutdown(), delayed items still go out at their due time, and
+ *   pop() returns false once nothing is pending and the ready Buffer is
+ *   drained. Destroying the DelayBuffer discards whatever is still pending,
+ *   including due items the timer could not hand to a full ready Buffer.
+ */
+template<typename T>
+class DelayBuffer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Buffer<T> ready_;
+    TimerWheel<T> wheel_;                   // Protected by mutex_
+    const Clock::duration tick_;
+    const Clock::time_point epoch_;
+    std::mutex mutex_;
+    std::condition_variable changed_;       // The timer thread waits here
+    uint64_t wake_tick_ = std::numeric_limits<uint64_t>::max();     // When the timer thread plans to wake
+    bool shutdown_ = false;
+    bool stop_ = false;                     // Destructor: discard pending items
+    std::thread timer_;
+
+    // Rounds up, so an item is never delivered early
+    uint64_t due_tick(Clock::time_point at) const {
+        if (at <= epoch_) {
+            return 0;
+        }
+        return static_cast<uint64_t>((at - epoch_ + tick_ - Clock::duration(1)) / tick_);
+    }
+
+    uint64_t now_tick() const { return static_cast<uint64_t>((Clock::now() - epoch_) / tick_); }
+
+    void run() {
+        std::vector<T> due;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            if (wheel_.empty()) {
+                if (shutdown_) {
+                    break;
+                }
+                wake_tick_ = std::numeric_limits<uint64_t>::max();
+                changed_.wait(lock);
+            } else {
+                wake_tick_ = wheel_.next_expiry();
+                changed_.wait_until(lock, epoch_ + tick_ * static_cast<int64_t>(wake_tick_));
+            }
+
+            wheel_.advance(now_tick(), [&due](T&& item) { due.push_back(std::move(item)); });
+            if (!due.empty()) {
+                // Pushing may block on a full ready Buffer; producers must not wait for that
+                lock.unlock();
+                for (T& item : due) {
+                    if (!ready_.push(std::move(item))) {
+                        break;              // Shut down by the destructor: discard the rest
+                    }
+                }
+                due.clear();
+                lock.lock();
+            }
+        }
+        lock.unlock();
+        ready_.shutdown();
+    }
+
+public:
+    explicit DelayBuffer(size_t capacity = 10, Clock::duration tick = std::chrono::milliseconds(1))
+        : ready_(capacity), tick_(tick), epoch_(Clock::now()) {
+        timer_ = std::thread([this] { run(); });
+    }
+
+    DelayBuffer(const DelayBuffer&) = delete;
+    DelayBuffer& operator=(const DelayBuffer&) = delete;
+
+    ~DelayBuffer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        changed_.notify_one();
+        // The timer thread may be blocked in push() on a full ready Buffer
+        // nobody consumes any more; shutting it down makes that push fail
+        ready_.shutdown();
+        timer_.join();
+    }
+
+    // Immediate delivery, exactly like Buffer::push (blocks while full)
+    bool push(T item) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (shutdown_) {
+                return false;
+            }
+        }
+        return ready_.push(std::move(item));
+    }
+
+    // Makes the item visible to pop() at `at`. Never blocks.
+    bool push_at(T item, Clock::time_point at) {
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (shutdown_) {
+                return false;
+            }
+            // The timer thread does not advance an empty wheel; catch up here
+            // rather than have its next advance() walk the whole idle period
+            if (wheel_.empty()) {
+                wheel_.skip_to(now_tick());
+            }
+            // Already due: the next tick is the earliest the timer thread can hand it over
+            uint64_t due = std::max(due_tick(at), wheel_.current() + 1);
+            wheel_.insert(due, item);
+            // Only disturb the timer thread if this item is due before it would wake anyway
+            if (due < wake_tick_) {
+                wake_tick_ = due;
+                wake = true;
+            }
+        }
+        if (wake) {
+            changed_.notify_one();
+        }
+        return true;
+    }
+
+    bool push_after(T item, Clock::duration delay) { return push_at(std::move(item), Clock::now() + delay); }
+
+    bool pop(T& item) { return ready_.pop(item); }
+    bool try_pop(T& item) { return ready_.try_pop(item); }
+    size_t pop_batch(std::vector<T>& out, size_t max_items = SIZE_MAX) { return ready_.pop_batch(out, max_items); }
+
+    // No new items; pending delayed items are still delivered when due
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        changed_.notify_one();
+    }
+
+    // Delayed items not yet due
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return wheel_.size();
+    }
+
+    // Items ready to pop
+    size_t size() const { return ready_.size(); }
+    bool empty() const { return ready_.empty(); }
+    size_t capacity() const { return ready_.capacity(); }
+};
+
+#endif // PRODUCER_CONSUMER_DELAY_BUFFER_H
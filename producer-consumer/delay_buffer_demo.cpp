@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "delay_buffer.h"
+
+/**
+ * Delay Buffer Demo
+ *
+ * 1. Timing: 20000 items are scheduled with random delays of 0-300 ms from
+ *    two producers that never sleep. The consumer checks that nothing is
+ *    delivered early and reports how late deliveries are.
+ * 2. Retries: a consumer whose tasks fail now and then reschedules them
+ *    with push_after() and exponential backoff, instead of sleeping in
+ *    the consumer (which would block every other task behind it).
+ */
+
+using Clock = std::chrono::steady_clock;
+
+struct Timed {
+    int id = 0;
+    Clock::time_point due;
+};
+
+struct Task {
+    int id = 0;
+    int attempt = 1;
+};
+
+int main() {
+    std::cout << "\n=== DELAY BUFFER DEMO ===\n";
+
+    // ---- Timing accuracy ----
+    {
+        const int PER_PRODUCER = 10000;
+        DelayBuffer<Timed> buffer(1024);
+        std::vector<std::thread> producers;
+        auto start = Clock::now();
+        for (int p = 0; p < 2; ++p) {
+            producers.emplace_back([&buffer, p] {
+                std::mt19937 rng(p + 1);
+                std::uniform_int_distribution<int> delay_ms(0, 300);
+                for (int i = 0; i < PER_PRODUCER; ++i) {
+                    auto delay = std::chrono::milliseconds(delay_ms(rng));
+                    buffer.push_after(Timed{p * PER_PRODUCER + i, Clock::now() + delay}, delay);
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        auto scheduled = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+        std::cout << "[PRODUCERS] scheduled " << 2 * PER_PRODUCER << " items in " << scheduled.count() / 1000.0
+                  << " ms (" << scheduled.count() * 1000 / (2 * PER_PRODUCER) << " ns per push_after)\n";
+        buffer.shutdown();
+
+        int delivered = 0;
+        int early = 0;
+        int64_t total_late_us = 0;
+        int64_t max_late_us = 0;
+        Timed item;
+        while (buffer.pop(item)) {
+            int64_t late_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - item.due).count();
+            if (late_us < 0) {
+                early++;
+            }
+            total_late_us += late_us;
+            max_late_us = std::max(max_late_us, late_us);
+            delivered++;
+        }
+        std::cout << "[CONSUMER] delivered " << delivered << ", early " << early
+                  << ", avg late " << total_late_us / std::max(delivered, 1) / 1000.0 << " ms"
+                  << ", max late " << max_late_us / 1000.0 << " ms\n\n";
+    }
+
+    // ---- Retries with backoff ----
+    {
+        const int NUM_TASKS = 5;
+        DelayBuffer<Task> buffer(16);
+        std::atomic<int> done{0};
+        auto start = Clock::now();
+        auto elapsed_ms = [start] {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+        };
+
+        std::thread consumer([&] {
+            Task task;
+            while (buffer.pop(task)) {
+                // Task n fails on its first n % 3 attempts
+                if (task.attempt <= task.id % 3) {
+                    auto backoff = std::chrono::milliseconds(20 << (task.attempt - 1));
+                    std::cout << "[CONSUMER] t=" << elapsed_ms() << "ms task " << task.id << " attempt "
+                              << task.attempt << " failed, retry in " << backoff.count() << " ms\n";
+                    buffer.push_after(Task{task.id, task.attempt + 1}, backoff);
+                    continue;
+                }
+                std::cout << "[CONSUMER] t=" << elapsed_ms() << "ms task " << task.id << " done on attempt "
+                          << task.attempt << "\n";
+                if (++done == NUM_TASKS) {
+                    buffer.shutdown();
+                }
+            }
+        });
+
+        for (int id = 1; id <= NUM_TASKS; ++id) {
+            buffer.push(Task{id, 1});
+        }
+        consumer.join();
+        std::cout << "[MAIN] " << done << "/" << NUM_TASKS << " tasks completed in " << elapsed_ms() << " ms\n";
+    }
+
+    std::cout << "\n=== DELAY BUFFER DEMO COMPLETED ===\n\n";
+    return 0;
+}
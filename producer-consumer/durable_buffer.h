@@ -0,0 +1,545 @@
+#ifndef PRODUCER_CONSUMER_DURABLE_BUFFER_H
+#define PRODUCER_CONSUMER_DURABLE_BUFFER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "codec.h"
+
+/**
+ * Durable Buffer with Write-Ahead Log
+ *
+ * If the process dies, everything still in a Buffer is lost. DurableBuffer
+ * writes every pushed item to a write-ahead log (WAL) before consumers can
+ * see it, and remembers which items consumers have acknowledged:
+ *
+ *   uint64_t seq;
+ *   buffer.push(item);                  // returns once the item is on disk
+ *   buffer.pop(item, seq);              // consumer gets the item + its sequence
+ *   process(item);
+ *   buffer.ack(seq);                    // done, never replay it
+ *
+ * - Group commit: a committer thread writes everything pushed since the
+ *   last sync with one write() and one fdatasync(). While one batch syncs,
+ *   the next one accumulates, so the cost of a sync is shared by all
+ *   producers that pushed in the meantime
+ * - Acks advance a watermark (every sequence <= watermark is done), which
+ *   is persisted with the next batch, or after a short idle interval
+ * - The WAL is a series of segment files (wal_000001.log, ...). Once the
+ *   current one reaches segment_bytes the next batch goes to a new one, and
+ *   a full segment is deleted as soon as the persisted watermark covers its
+ *   last record. So the WAL, and the time to replay it, stays bounded by the
+ *   unacknowledged backlog even under sustained load. When everything is
+ *   acknowledged the current segment is truncated as well
+ * - On construction, the WAL in `directory` is replayed: every record above
+ *   the watermark is queued again (at-least-once delivery). Records are
+ *   checksummed, so a torn write at the tail from a crash is cut off
+ *
+ * Items are serialized with ItemCodec<T> (see codec.h). I/O errors are
+ * reported as std::system_error from push().
+ */
+template<typename T, typename Codec = ItemCodec<T>>
+class DurableBuffer {
+private:
+    // On-disk record: header followed by `length` payload bytes
+    struct RecordHeader {
+        uint64_t sequence;
+        uint32_t length;
+        uint32_t checksum;                  // FNV-1a over sequence, length and payload
+    };
+
+    struct Entry {
+        uint64_t sequence;
+        T item;
+    };
+
+    // A WAL segment that is full and no longer written
+    struct SealedSegment {
+        uint64_t index;
+        uint64_t last_sequence;             // Highest sequence it holds
+    };
+
+    std::filesystem::path directory_;
+    int wal_fd_ = -1;                       // The segment batches are appended to
+    int ack_fd_ = -1;
+    const size_t capacity_;
+    const size_t max_batch_;
+    const size_t segment_bytes_;
+
+    // Only touched by recover() and then the committer thread
+    uint64_t wal_index_ = 0;
+    size_t wal_bytes_ = 0;
+    std::deque<SealedSegment> sealed_;      // Oldest first
+    uint64_t persisted_watermark_ = 0;      // The watermark in ack.log
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;     // Consumers: a durable item is available
+    std::condition_variable not_full_;      // Producers: room in memory / in the batch
+    std::condition_variable durable_;       // Producers: their batch has been synced
+    std::condition_variable commit_;        // Committer: there is something to sync
+
+    std::deque<Entry> memory_;              // Not yet popped
+    std::string pending_;                   // Serialized records not yet written
+    size_t pending_count_ = 0;
+    uint64_t next_sequence_ = 1;
+    uint64_t durable_sequence_ = 0;         // Everything <= this is synced
+    uint64_t ack_watermark_ = 0;            // Everything <= this is acknowledged
+    std::set<uint64_t> acked_above_;        // Out-of-order acks above the watermark
+    bool ack_dirty_ = false;
+    bool shutdown_ = false;
+    bool stopping_ = false;
+    int io_error_ = 0;
+
+    uint64_t recovered_ = 0;
+    uint64_t batches_ = 0;
+    uint64_t synced_records_ = 0;
+
+    std::thread committer_;
+
+    static constexpr std::chrono::milliseconds ACK_FLUSH_INTERVAL{10};
+
+    static uint32_t checksum(const RecordHeader& header, const char* payload) {
+        uint32_t hash = 2166136261u;
+        auto mix = [&hash](const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 16777619u;
+            }
+        };
+        mix(&header.sequence, sizeof(header.sequence));
+        mix(&header.length, sizeof(header.length));
+        mix(payload, header.length);
+        return hash;
+    }
+
+    static void fail(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static bool write_all(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t written = ::write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    std::filesystem::path segment_path(uint64_t index) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "wal_%06llu.log", static_cast<unsigned long long>(index));
+        return directory_ / name;
+    }
+
+    // "wal_<index>.log"
+    static bool parse_segment_name(const std::string& name, uint64_t& index) {
+        unsigned long long value = 0;
+        int consumed = 0;
+        if (std::sscanf(name.c_str(), "wal_%llu.log%n", &value, &consumed) != 1 ||
+            static_cast<size_t>(consumed) != name.size()) {
+            return false;
+        }
+        index = value;
+        return true;
+    }
+
+    int open_segment(uint64_t index) const {
+        return ::open(segment_path(index).c_str(), O_RDWR | O_CREAT | O_APPEND, 0600);
+    }
+
+    // A new segment file must survive a crash too
+    bool sync_directory() const {
+        int fd = ::open(directory_.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) {
+            return false;
+        }
+        bool synced = fsync(fd) == 0;
+        ::close(fd);
+        return synced;
+    }
+
+    // Committer: later batches go to a fresh segment. Returns an errno or 0.
+    int rotate_segment(uint64_t last_sequence) {
+        int fd = ::open(segment_path(wal_index_ + 1).c_str(), O_RDWR | O_CREAT | O_APPEND | O_TRUNC, 0600);
+        if (fd < 0 || !sync_directory()) {
+            int error = errno;
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return error;
+        }
+        ::close(wal_fd_);
+        sealed_.push_back(SealedSegment{wal_index_, last_sequence});
+        wal_fd_ = fd;
+        wal_index_++;
+        wal_bytes_ = 0;
+        return 0;
+    }
+
+    // Committer: full segments whose records are all acknowledged on disk
+    void delete_acknowledged_segments() {
+        while (!sealed_.empty() && sealed_.front().last_sequence <= persisted_watermark_) {
+            ::unlink(segment_path(sealed_.front().index).c_str());      // Replay skips it anyway
+            sealed_.pop_front();
+        }
+    }
+
+    // Replays one segment: queues its unacknowledged records, cuts off a
+    // torn tail and returns the valid length
+    size_t replay_segment(int fd, uint64_t& last_sequence) {
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            fail("fstat wal");
+        }
+        std::vector<char> wal(static_cast<size_t>(info.st_size));
+        if (!wal.empty() && ::pread(fd, wal.data(), wal.size(), 0) != static_cast<ssize_t>(wal.size())) {
+            fail("read wal");
+        }
+
+        size_t offset = 0;
+        while (offset + sizeof(RecordHeader) <= wal.size()) {
+            RecordHeader header;
+            std::memcpy(&header, wal.data() + offset, sizeof(header));
+            const char* payload = wal.data() + offset + sizeof(header);
+            if (offset + sizeof(header) + header.length > wal.size() ||
+                checksum(header, payload) != header.checksum) {
+                break;                      // Torn or corrupt tail
+            }
+            if (header.sequence > ack_watermark_) {
+                Entry entry{header.sequence, T()};
+                Codec::decode(payload, header.length, entry.item);
+                memory_.push_back(std::move(entry));
+                recovered_++;
+            }
+            last_sequence = std::max(last_sequence, header.sequence);
+            offset += sizeof(header) + header.length;
+        }
+
+        if (offset != wal.size() && ftruncate(fd, static_cast<off_t>(offset)) != 0) {
+            fail("truncate wal");
+        }
+        return offset;
+    }
+
+    // Reads the watermark and WAL segments left by a previous run, oldest
+    // first; the newest segment stays open for appending
+    void recover() {
+        uint64_t watermark = 0;
+        if (::pread(ack_fd_, &watermark, sizeof(watermark), 0) == sizeof(watermark)) {
+            ack_watermark_ = watermark;
+        }
+        persisted_watermark_ = ack_watermark_;
+
+        std::vector<uint64_t> indexes;
+        for (const auto& file : std::filesystem::directory_iterator(directory_)) {
+            uint64_t index;
+            if (parse_segment_name(file.path().filename().string(), index)) {
+                indexes.push_back(index);
+            }
+        }
+        std::sort(indexes.begin(), indexes.end());
+
+        uint64_t last_sequence = ack_watermark_;
+        for (size_t i = 0; i < indexes.size(); ++i) {
+            int fd = open_segment(indexes[i]);
+            if (fd < 0) {
+                fail("open " + segment_path(indexes[i]).string());
+            }
+            size_t length = replay_segment(fd, last_sequence);
+            if (i + 1 == indexes.size()) {
+                wal_fd_ = fd;
+                wal_index_ = indexes[i];
+                wal_bytes_ = length;
+            } else {
+                ::close(fd);
+                sealed_.push_back(SealedSegment{indexes[i], last_sequence});
+            }
+        }
+        delete_acknowledged_segments();
+
+        if (wal_fd_ < 0) {
+            wal_index_ = 1;
+            wal_fd_ = open_segment(wal_index_);
+            if (wal_fd_ < 0 || !sync_directory()) {
+                fail("open " + segment_path(wal_index_).string());
+            }
+        }
+        next_sequence_ = last_sequence + 1;
+        durable_sequence_ = last_sequence;
+    }
+
+    void run_committer() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            if (ack_dirty_) {
+                // Acks alone do not trigger a sync: they ride along with the
+                // next batch, or are flushed after ACK_FLUSH_INTERVAL
+                commit_.wait_for(lock, ACK_FLUSH_INTERVAL, [this] { return !pending_.empty() || stopping_; });
+            } else {
+                // Idle: sleep until a push, the first unflushed ack or shutdown
+                commit_.wait(lock, [this] { return !pending_.empty() || ack_dirty_ || stopping_; });
+                if (pending_.empty() && !stopping_) {
+                    continue;               // Only an ack: give it ACK_FLUSH_INTERVAL to find a batch
+                }
+            }
+            if (pending_.empty() && !ack_dirty_) {
+                if (stopping_) {
+                    break;                  // Nothing left to sync
+                }
+                continue;
+            }
+
+            std::string batch;
+            batch.swap(pending_);
+            size_t batch_count = pending_count_;
+            pending_count_ = 0;
+            uint64_t batch_last = next_sequence_ - 1;
+            bool write_ack = ack_dirty_;
+            ack_dirty_ = false;
+            uint64_t watermark = ack_watermark_;
+            // After a failed sync the WAL may end in a partial batch; stop writing it
+            int error = io_error_;
+            // Producers blocked on max_batch can start filling the next batch
+            not_full_.notify_all();
+            lock.unlock();
+
+            if (!error && !batch.empty() &&
+                (!write_all(wal_fd_, batch.data(), batch.size()) || fdatasync(wal_fd_) != 0)) {
+                error = errno;
+            }
+            if (!error && !batch.empty()) {
+                wal_bytes_ += batch.size();
+                if (wal_bytes_ >= segment_bytes_) {
+                    error = rotate_segment(batch_last);
+                }
+            }
+            if (!error && write_ack) {
+                if (::pwrite(ack_fd_, &watermark, sizeof(watermark), 0) != sizeof(watermark) ||
+                    fdatasync(ack_fd_) != 0) {
+                    error = errno;
+                } else {
+                    persisted_watermark_ = watermark;
+                    delete_acknowledged_segments();
+                }
+            }
+            // Everything written so far is acknowledged: start the current segment over
+            if (!error && batch.empty() && write_ack && watermark == batch_last) {
+                if (ftruncate(wal_fd_, 0) != 0) {
+                    error = errno;
+                }
+                wal_bytes_ = 0;
+            }
+
+            lock.lock();
+            if (error) {
+                io_error_ = error;
+            }
+            // Consumers only ever see items that really are on disk
+            if (!error && !batch.empty()) {
+                durable_sequence_ = batch_last;
+                batches_++;
+                synced_records_ += batch_count;
+            }
+            durable_.notify_all();
+            not_empty_.notify_all();
+        }
+    }
+
+    bool enqueue(const T& item, bool wait_durable) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] {
+            return (memory_.size() < capacity_ && pending_count_ < max_batch_) || shutdown_ || io_error_;
+        });
+        if (io_error_) {
+            throw std::system_error(io_error_, std::generic_category(), "wal commit");
+        }
+        if (shutdown_) {
+            return false;
+        }
+
+        RecordHeader header{next_sequence_++, static_cast<uint32_t>(Codec::size(item)), 0};
+        size_t offset = pending_.size();
+        pending_.resize(offset + sizeof(header) + header.length);
+        char* payload = &pending_[offset + sizeof(header)];
+        Codec::encode(item, payload);
+        header.checksum = checksum(header, payload);
+        std::memcpy(&pending_[offset], &header, sizeof(header));
+        pending_count_++;
+        memory_.push_back(Entry{header.sequence, item});
+        commit_.notify_one();
+
+        if (!wait_durable) {
+            return true;
+        }
+        durable_.wait(lock, [this, &header] { return durable_sequence_ >= header.sequence || io_error_; });
+        if (io_error_) {
+            throw std::system_error(io_error_, std::generic_category(), "wal commit");
+        }
+        return true;
+    }
+
+public:
+    // max_batch limits how many records one group commit may hold;
+    // 1 means every push pays its own fdatasync(). segment_bytes is the WAL
+    // segment size at which the committer moves on to a new file.
+    DurableBuffer(std::filesystem::path directory, size_t capacity = 1024, size_t max_batch = 4096,
+                  size_t segment_bytes = 64 << 20)
+        : directory_(std::move(directory)), capacity_(capacity), max_batch_(max_batch < 1 ? 1 : max_batch),
+          segment_bytes_(segment_bytes) {
+        std::filesystem::create_directories(directory_);
+        ack_fd_ = ::open((directory_ / "ack.log").c_str(), O_RDWR | O_CREAT, 0600);
+        if (ack_fd_ < 0) {
+            fail("open ack.log");
+        }
+        try {
+            recover();
+        } catch (...) {
+            if (wal_fd_ >= 0) {
+                ::close(wal_fd_);
+            }
+            ::close(ack_fd_);
+            throw;
+        }
+        committer_ = std::thread(&DurableBuffer::run_committer, this);
+    }
+
+    DurableBuffer(const DurableBuffer&) = delete;
+    DurableBuffer& operator=(const DurableBuffer&) = delete;
+
+    // Syncs what is pending; unacknowledged items stay in the WAL
+    ~DurableBuffer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            shutdown_ = true;
+        }
+        commit_.notify_one();
+        not_empty_.notify_all();
+        not_full_.notify_all();
+        committer_.join();
+        ::close(wal_fd_);
+        ::close(ack_fd_);
+    }
+
+    // Returns once the item is durable. Returns false after shutdown().
+    bool push(const T& item) {
+        return enqueue(item, true);
+    }
+
+    // Returns as soon as the item is in the next batch. Consumers still only
+    // see it once it is durable, but the producer does not wait for the sync,
+    // so a single producer can fill a whole batch.
+    bool push_nowait(const T& item) {
+        return enqueue(item, false);
+    }
+
+    // Blocks until a durable item is available or the buffer is shut down and
+    // drained. Items pushed with push_nowait() before shutdown() are still
+    // delivered once their batch has been synced. After a WAL error, items
+    // that never made it to disk are not delivered and pop() returns false.
+    bool pop(T& item, uint64_t& sequence) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] {
+            return (!memory_.empty() && memory_.front().sequence <= durable_sequence_) || io_error_ ||
+                   (shutdown_ && memory_.empty());
+        });
+        if (memory_.empty() || memory_.front().sequence > durable_sequence_) {
+            return false;
+        }
+
+        item = std::move(memory_.front().item);
+        sequence = memory_.front().sequence;
+        memory_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // Marks an item as processed; it will not be replayed after a restart
+    void ack(uint64_t sequence) {
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (sequence <= ack_watermark_) {
+                return;
+            }
+            acked_above_.insert(sequence);
+            auto it = acked_above_.begin();
+            uint64_t watermark = ack_watermark_;
+            while (it != acked_above_.end() && *it == ack_watermark_ + 1) {
+                ack_watermark_++;
+                it = acked_above_.erase(it);
+            }
+            // Only a moved watermark needs persisting, and only the first one
+            // since the last flush needs to wake an idle committer
+            if (ack_watermark_ != watermark && !ack_dirty_) {
+                ack_dirty_ = true;
+                wake = true;
+            }
+        }
+        if (wake) {
+            commit_.notify_one();
+        }
+    }
+
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return memory_.size();
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Records replayed from a previous run
+    uint64_t recovered() const { return recovered_; }
+
+    uint64_t ack_watermark() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ack_watermark_;
+    }
+
+    // Average records per fdatasync() shows how well group commit works
+    uint64_t batches() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batches_;
+    }
+
+    uint64_t synced_records() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return synced_records_;
+    }
+};
+
+#endif // PRODUCER_CONSUMER_DURABLE_BUFFER_H
@@ -0,0 +1,168 @@
+#ifndef PRODUCER_CONSUMER_FLOW_CONTROL_H
+#define PRODUCER_CONSUMER_FLOW_CONTROL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+/**
+ * Credit-Based Flow Control
+ *
+ * Blocking in Buffer::push when the buffer is full is a crude form of
+ * backpressure: producers run at full speed until they hit the wall, stall,
+ * and then all rush in again once space frees up.
+ *
+ * CreditGate makes the protocol explicit:
+ * - Consumers grant() one credit for every item they finish processing
+ * - Producers spend one credit per item (try_acquire()/acquire())
+ * - The initial credit window bounds the number of items in flight
+ *
+ * AimdController (one per producer) turns "I had to wait for a credit" into
+ * a rate signal, like TCP congestion control:
+ * - Additive increase: every item sent without waiting raises the rate a bit
+ * - Multiplicative decrease: waiting for a credit cuts the rate by a factor
+ * so each producer converges to its share of the sustainable consumption
+ * rate instead of oscillating between full stall and idle.
+ */
+
+class CreditGate {
+private:
+    std::atomic<int64_t> credits_;
+    std::atomic<bool> shutdown_{false};
+    std::mutex mutex_;                      // Only used by producers that have to wait
+    std::condition_variable has_credit_;
+    std::atomic<uint64_t> stalls_{0};
+
+public:
+    explicit CreditGate(int64_t initial_credits) : credits_(initial_credits) {}
+
+    CreditGate(const CreditGate&) = delete;
+    CreditGate& operator=(const CreditGate&) = delete;
+
+    // Lock-free fast path: spend a credit if one is available
+    bool try_acquire() {
+        int64_t available = credits_.load(std::memory_order_relaxed);
+        while (available > 0) {
+            if (credits_.compare_exchange_weak(available, available - 1, std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Blocks until a credit is available. Returns false after shutdown().
+    bool acquire() {
+        if (try_acquire()) {
+            return true;
+        }
+
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!shutdown_.load()) {
+            if (try_acquire()) {
+                return true;
+            }
+            has_credit_.wait(lock);
+        }
+        return false;
+    }
+
+    // Consumers call this after processing `count` items
+    void grant(int64_t count = 1) {
+        credits_.fetch_add(count, std::memory_order_release);
+        {
+            // Taking the lock orders this grant with a producer that has just
+            // failed try_acquire() but not started waiting yet (no lost wakeup)
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        if (count == 1) {
+            has_credit_.notify_one();
+        } else {
+            has_credit_.notify_all();
+        }
+    }
+
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_.store(true);
+        }
+        has_credit_.notify_all();
+    }
+
+    int64_t available() const { return credits_.load(std::memory_order_relaxed); }
+    uint64_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+};
+
+struct AimdConfig {
+    double initial_rate = 50.0;             // Items per second
+    double min_rate = 1.0;
+    double max_rate = 100000.0;
+    double additive_increase = 2.0;         // Items/s added per item sent without waiting
+    double multiplicative_decrease = 0.5;   // Rate factor applied on congestion
+    std::chrono::milliseconds decrease_interval{50};  // At most one decrease per interval
+};
+
+// Paces a single producer. Not thread-safe: give every producer its own.
+class AimdController {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    AimdConfig config_;
+    double rate_;
+    Clock::time_point next_send_;
+    Clock::time_point last_decrease_;
+
+public:
+    explicit AimdController(AimdConfig config = AimdConfig())
+        : config_(config), rate_(config.initial_rate), next_send_(Clock::now()),
+          last_decrease_(Clock::now() - config.decrease_interval) {}
+
+    // Sleeps until the current rate allows the next item to be sent
+    void pace() {
+        auto now = Clock::now();
+        if (next_send_ > now) {
+            std::this_thread::sleep_until(next_send_);
+            now = next_send_;
+        }
+        auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate_));
+        next_send_ = now + interval;
+    }
+
+    void on_success() {
+        rate_ = std::min(config_.max_rate, rate_ + config_.additive_increase);
+    }
+
+    void on_congestion() {
+        // One congestion event usually stalls several items in a row; only
+        // react to it once, like TCP does once per round trip
+        auto now = Clock::now();
+        if (now - last_decrease_ < config_.decrease_interval) {
+            return;
+        }
+        last_decrease_ = now;
+        rate_ = std::max(config_.min_rate, rate_ * config_.multiplicative_decrease);
+    }
+
+    // pace() + spend a credit, feeding the outcome back into the rate.
+    // Returns false if the gate was shut down.
+    bool send_permit(CreditGate& gate) {
+        pace();
+        if (gate.try_acquire()) {
+            on_success();
+            return true;
+        }
+        on_congestion();
+        return gate.acquire();
+    }
+
+    double rate() const { return rate_; }
+};
+
+#endif // PRODUCER_CONSUMER_FLOW_CONTROL_H
@@ -0,0 +1,133 @@
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer.h"
+#include "flow_control.h"
+
+/**
+ * Credit-Based Flow Control Demo
+ *
+ * Same topology as multi_producer_consumer.cpp (3 producers, shared Buffer),
+ * but instead of a hardcoded sleep_for(300 + id*100 ms) each producer is paced
+ * by an AimdController. The consumer grants a credit back for every item it
+ * finishes, so the producers' combined rate converges to the consumer's
+ * processing rate (~200 items/s here) and the Buffer never fills up.
+ */
+
+class Producer {
+private:
+    Buffer<std::string>& buffer_;
+    CreditGate& credits_;
+    std::atomic<bool>& running_;
+    AimdController controller_;
+    std::atomic<double> rate_{0.0};         // Published for the monitor in main()
+    std::atomic<int> produced_{0};
+    int id_;
+
+public:
+    Producer(Buffer<std::string>& buffer, CreditGate& credits, std::atomic<bool>& running, int id,
+             AimdConfig config)
+        : buffer_(buffer), credits_(credits), running_(running), controller_(config), id_(id) {}
+
+    void produce() {
+        std::cout << "[PRODUCER " << id_ << "] Starting at " << controller_.rate() << " items/s\n";
+
+        int count = 0;
+        while (running_.load()) {
+            if (!controller_.send_permit(credits_)) {
+                break;
+            }
+            buffer_.push("P" + std::to_string(id_) + "_Msg_" + std::to_string(count++));
+            rate_.store(controller_.rate());
+            produced_.store(count);
+        }
+
+        std::cout << "[PRODUCER " << id_ << "] Stopping. Total produced: " << count << "\n";
+    }
+
+    double rate() const { return rate_.load(); }
+    int produced() const { return produced_.load(); }
+};
+
+class Consumer {
+private:
+    Buffer<std::string>& buffer_;
+    CreditGate& credits_;
+    std::atomic<int> consumed_{0};
+
+public:
+    Consumer(Buffer<std::string>& buffer, CreditGate& credits) : buffer_(buffer), credits_(credits) {}
+
+    void consume() {
+        std::string data;
+        while (buffer_.pop(data)) {
+            // Fixed service time: this is the sustainable rate producers converge to
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            consumed_.fetch_add(1);
+
+            // Processing done: hand the slot back to the producers
+            credits_.grant();
+        }
+    }
+
+    int consumed() const { return consumed_.load(); }
+};
+
+int main() {
+    std::cout << "\n=== CREDIT-BASED FLOW CONTROL DEMO ===\n";
+
+    const int NUM_PRODUCERS = 3;
+    const size_t WINDOW = 10;
+
+    Buffer<std::string> shared_buffer(WINDOW);
+    CreditGate credits(WINDOW);             // Never more items in flight than the buffer holds
+    std::atomic<bool> running{true};
+
+    std::vector<std::unique_ptr<Producer>> producers;
+    std::vector<std::thread> producer_threads;
+    Consumer consumer(shared_buffer, credits);
+    std::thread consumer_thread(&Consumer::consume, &consumer);
+
+    for (int i = 1; i <= NUM_PRODUCERS; ++i) {
+        AimdConfig config;
+        config.initial_rate = 20.0 * i * i;  // Deliberately unequal start
+        producers.emplace_back(std::make_unique<Producer>(shared_buffer, credits, running, i, config));
+        producer_threads.emplace_back(&Producer::produce, producers.back().get());
+    }
+
+    // Watch the rates converge
+    std::cout << std::fixed << std::setprecision(1);
+    int last_consumed = 0;
+    for (int tick = 1; tick <= 8; ++tick) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        int consumed = consumer.consumed();
+        std::cout << "[MAIN] t=" << tick * 0.5 << "s consumer=" << (consumed - last_consumed) * 2
+                  << " items/s buffer=" << shared_buffer.size() << " |";
+        for (const auto& producer : producers) {
+            std::cout << " rate=" << producer->rate();
+        }
+        std::cout << "\n";
+        last_consumed = consumed;
+    }
+
+    std::cout << "\n[MAIN] Initiating shutdown...\n";
+    running.store(false);
+    credits.shutdown();
+    for (auto& thread : producer_threads) {
+        thread.join();
+    }
+    shared_buffer.shutdown();
+    consumer_thread.join();
+
+    std::cout << "\n[MAIN] Consumed: " << consumer.consumed() << ", producer stalls: " << credits.stalls()
+              << "\n";
+    std::cout << "=== FLOW CONTROL DEMO COMPLETED ===\n\n";
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "fusion.h"
+#include "pipeline.h"
+
+/**
+ * Stage Fusion Demo
+ *
+ * Runs the same four-step pipeline three ways and compares throughput:
+ * 1. Buffered:   every step is its own thread, with a Buffer between each pair
+ * 2. Auto-fused: the builder fuses adjacent single-threaded steps (no Buffers)
+ * 3. Compile-time fused: fuse_stages() + run_fused() on the main thread
+ *
+ * Every Buffer handoff costs a lock, a notify and a cache transfer, so for
+ * cheap steps like these the fused versions are much faster.
+ */
+
+const uint64_t NUM_ITEMS = 200000;
+
+struct Source {
+    uint64_t next = 0;
+
+    bool operator()(uint64_t& item) {
+        if (next >= NUM_ITEMS) {
+            return false;
+        }
+        item = next++;
+        return true;
+    }
+};
+
+uint64_t parse(uint64_t raw) { return (raw * 2654435761u) % 1000; }
+uint64_t enrich(uint64_t value) { return value + 1; }
+
+// Stateful, so every variant runs it on exactly one thread
+struct Aggregate {
+    uint64_t running_total = 0;
+
+    uint64_t operator()(uint64_t value) {
+        running_total += value;
+        return running_total;
+    }
+};
+
+template<typename Body>
+void report(const std::string& label, Body body) {
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    body(checksum);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    double per_second = elapsed > 0 ? NUM_ITEMS * 1e6 / elapsed : 0.0;
+    std::cout << "[" << label << "] " << elapsed / 1000.0 << " ms, "
+              << static_cast<uint64_t>(per_second) << " items/s, checksum " << checksum << "\n";
+}
+
+int main() {
+    std::cout << "\n=== STAGE FUSION DEMO ===\n";
+    std::cout << "Processing " << NUM_ITEMS << " items per variant\n\n";
+
+    report("BUFFERED  ", [](uint64_t& checksum) {
+        auto pipeline = make_pipeline<uint64_t>("source", Source{}, 1024)
+            .stage("parse", 1, parse)
+            .stage("enrich", 1, enrich)
+            .stage("aggregate", 1, Aggregate{})
+            .sink("sink", 1, [&checksum](uint64_t total) { checksum ^= total; });
+        std::cout << "[BUFFERED  ] ";
+        pipeline->describe(std::cout);
+        pipeline->start();
+        pipeline->wait();
+    });
+
+    report("AUTO-FUSED", [](uint64_t& checksum) {
+        auto pipeline = make_pipeline<uint64_t>("source", Source{}, 1024)
+            .auto_fuse()
+            .stage("parse", 1, parse)
+            .stage("enrich", 1, enrich)
+            .stage("aggregate", 1, Aggregate{})
+            .sink("sink", 1, [&checksum](uint64_t total) { checksum ^= total; });
+        std::cout << "[AUTO-FUSED] ";
+        pipeline->describe(std::cout);
+        pipeline->start();
+        pipeline->wait();
+    });
+
+    report("STATIC    ", [](uint64_t& checksum) {
+        auto stage = fuse_stages(parse, enrich, Aggregate{});
+        std::cout << "[STATIC    ] source+parse+enrich+aggregate+sink x1 (single loop)\n";
+        run_fused<uint64_t>(Source{}, stage, [&checksum](uint64_t total) { checksum ^= total; });
+    });
+
+    std::cout << "\n=== FUSION DEMO COMPLETED ===\n\n";
+
+    return 0;
+}
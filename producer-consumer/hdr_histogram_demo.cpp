@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "buffer.h"
+#include "hdr_histogram.h"
+#include "latency_trace.h"
+
+/**
+ * HDR Histogram Demo
+ *
+ * 1. Cost and accuracy: 2 million log-normally distributed "latencies" are
+ *    recorded into a vector (then sorted), an HdrHistogram and a
+ *    ConcurrentHistogram, and the percentiles are compared.
+ * 2. Sharing: two producers record how long push() blocked and two
+ *    consumers record how long pop() waited, all into shared
+ *    ConcurrentHistograms, with no lock on the recording path.
+ */
+
+const size_t NUM_SAMPLES = 2000000;
+const double PERCENTILES[] = {50, 90, 99, 99.9, 99.99};
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    std::cout << "\n=== HDR HISTOGRAM DEMO ===\n";
+
+    // ---- Cost and accuracy ----
+    std::vector<uint64_t> samples(NUM_SAMPLES);
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> latency(std::log(20000.0), 0.8);   // ~20 us median
+    for (uint64_t& sample : samples) {
+        sample = static_cast<uint64_t>(latency(rng));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint64_t> recorded;
+    for (uint64_t sample : samples) {
+        recorded.push_back(sample);
+    }
+    std::sort(recorded.begin(), recorded.end());
+    double vector_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    HdrHistogram histogram;
+    for (uint64_t sample : samples) {
+        histogram.record(sample);
+    }
+    double hdr_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    ConcurrentHistogram concurrent;
+    for (uint64_t sample : samples) {
+        concurrent.record(sample);
+    }
+    HdrHistogram snapshot = concurrent.snapshot();
+    double concurrent_ms = elapsed_ms(start);
+
+    std::printf("[COST] %zu samples: vector+sort %.1f ms, HdrHistogram %.1f ms, ConcurrentHistogram %.1f ms\n",
+                NUM_SAMPLES, vector_ms, hdr_ms, concurrent_ms);
+    std::printf("[ACCURACY] %-8s %12s %12s %12s %8s\n", "pct", "exact ns", "hdr ns", "concurrent", "error");
+    for (double percentile : PERCENTILES) {
+        size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * NUM_SAMPLES));
+        uint64_t exact = recorded[std::max<size_t>(rank, 1) - 1];
+        uint64_t approx = histogram.percentile(percentile);
+        double error = 100.0 * (static_cast<double>(approx) - static_cast<double>(exact)) / static_cast<double>(exact);
+        std::printf("[ACCURACY] p%-7g %12llu %12llu %12llu %7.2f%%\n", percentile,
+                    static_cast<unsigned long long>(exact), static_cast<unsigned long long>(approx),
+                    static_cast<unsigned long long>(snapshot.percentile(percentile)), error);
+    }
+
+    // ---- Shared recording from producers and consumers ----
+    {
+        Buffer<int> buffer(16);
+        ConcurrentHistogram push_wait;
+        ConcurrentHistogram pop_wait;
+        const int PER_PRODUCER = 50000;
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < 2; ++p) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < PER_PRODUCER; ++i) {
+                    uint64_t before = TscClock::ticks();
+                    buffer.push(i);
+                    push_wait.record(TscClock::instance().to_ns(TscClock::ticks() - before));
+                }
+            });
+        }
+        std::vector<std::thread> consumers;
+        for (int c = 0; c < 2; ++c) {
+            consumers.emplace_back([&] {
+                int item;
+                for (;;) {
+                    uint64_t before = TscClock::ticks();
+                    if (!buffer.pop(item)) {
+                        break;
+                    }
+                    pop_wait.record(TscClock::instance().to_ns(TscClock::ticks() - before));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        buffer.shutdown();
+        for (auto& consumer : consumers) {
+            consumer.join();
+        }
+
+        for (const auto& entry : {std::make_pair("PRODUCERS] push", &push_wait),
+                                  std::make_pair("CONSUMERS] pop ", &pop_wait)}) {
+            HdrHistogram h = entry.second->snapshot();
+            std::printf("[%s: count %llu, p50 %.1f us, p99 %.1f us, max %.1f us\n", entry.first,
+                        static_cast<unsigned long long>(h.count()), h.percentile(50) / 1000.0,
+                        h.percentile(99) / 1000.0, h.max() / 1000.0);
+        }
+    }
+
+    std::cout << "\n=== HDR HISTOGRAM DEMO COMPLETED ===\n\n";
+    return 0;
+}
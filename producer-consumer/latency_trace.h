@@ -0,0 +1,134 @@
+#ifndef PRODUCER_CONSUMER_LATENCY_TRACE_H
+#define PRODUCER_CONSUMER_LATENCY_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer.h"
+#include "hdr_histogram.h"
+#include "tsc_clock.h"
+
+/**
+ * End-to-End Latency Tracing
+ *
+ * A message that takes 5 ms end to end may have spent 4.9 ms queued and
+ * 0.1 ms being processed, or the other way round; the fix is completely
+ * different. Tracing stamps four timestamps on each message:
+ *
+ *   produced --(backpressure)--> enqueued --(queueing)--> dequeued --(service)--> processed
+ *
+ * - produced: the producer created the message (Traced<T> constructor)
+ * - enqueued: push() found room and is queueing the message; the gap
+ *   since `produced` is time spent blocked on a full buffer
+ * - dequeued: pop() returned it to a consumer
+ * - processed: the consumer called complete()
+ *
+ * TracedBuffer<T> wraps a Buffer<Traced<T>> and stamps enqueue/dequeue
+ * itself, so tracing is opt-in per buffer and costs nothing elsewhere.
+ * Timestamps come from TscClock (see tsc_clock.h).
+ *
+ * Durations go into per-stage ConcurrentHistograms, so every consumer can
+ * record into the same StageLatencies without contending.
+ */
+
+template<typename T>
+struct Traced {
+    T item{};
+    uint64_t produced = 0;
+    uint64_t enqueued = 0;
+    uint64_t dequeued = 0;
+
+    Traced() = default;
+    explicit Traced(T value) : item(std::move(value)), produced(TscClock::ticks()) {}
+};
+
+enum class Stage { Backpressure, Queueing, Service, EndToEnd };
+
+inline const char* to_string(Stage stage) {
+    switch (stage) {
+        case Stage::Backpressure: return "backpressure";
+        case Stage::Queueing:     return "queueing";
+        case Stage::Service:      return "service";
+        case Stage::EndToEnd:     return "end-to-end";
+    }
+    return "unknown";
+}
+
+// One histogram per stage, in nanoseconds. record() is thread-safe.
+class StageLatencies {
+private:
+    static const size_t STAGES = 4;
+
+    ConcurrentHistogram stages_[STAGES];
+
+public:
+    template<typename T>
+    void record(const Traced<T>& message, uint64_t processed) {
+        const TscClock& clock = TscClock::instance();
+        stages_[static_cast<size_t>(Stage::Backpressure)].record(clock.to_ns(message.enqueued - message.produced));
+        stages_[static_cast<size_t>(Stage::Queueing)].record(clock.to_ns(message.dequeued - message.enqueued));
+        stages_[static_cast<size_t>(Stage::Service)].record(clock.to_ns(processed - message.dequeued));
+        stages_[static_cast<size_t>(Stage::EndToEnd)].record(clock.to_ns(processed - message.produced));
+    }
+
+    HdrHistogram stage(Stage stage) const { return stages_[static_cast<size_t>(stage)].snapshot(); }
+
+    // One line per stage: count, p50, p99, p99.9, max (in microseconds)
+    std::string report() const {
+        std::string out;
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-13s %9s %10s %10s %10s %10s\n",
+                      "stage", "count", "p50 us", "p99 us", "p99.9 us", "max us");
+        out += line;
+        for (Stage stage : {Stage::Backpressure, Stage::Queueing, Stage::Service, Stage::EndToEnd}) {
+            HdrHistogram h = this->stage(stage);
+            std::snprintf(line, sizeof(line), "%-13s %9llu %10.1f %10.1f %10.1f %10.1f\n", to_string(stage),
+                          static_cast<unsigned long long>(h.count()), h.percentile(50) / 1000.0,
+                          h.percentile(99) / 1000.0, h.percentile(99.9) / 1000.0, h.max() / 1000.0);
+            out += line;
+        }
+        return out;
+    }
+};
+
+// A Buffer that stamps messages on the way in and out
+template<typename T>
+class TracedBuffer {
+private:
+    Buffer<Traced<T>> buffer_;
+
+public:
+    explicit TracedBuffer(size_t capacity = 10) : buffer_(capacity) {
+        TscClock::instance();               // Calibrate now, not on the first message
+    }
+
+    bool push(Traced<T> message) {
+        // Stamped under the lock once there is room, so the gap to
+        // `produced` is the time push() spent waiting for it
+        return buffer_.push(std::move(message), [](Traced<T>& queued) { queued.enqueued = TscClock::ticks(); });
+    }
+
+    bool pop(Traced<T>& message) {
+        if (!buffer_.pop(message)) {
+            return false;
+        }
+        message.dequeued = TscClock::ticks();
+        return true;
+    }
+
+    // The consumer is done with `message`
+    void complete(const Traced<T>& message, StageLatencies& latencies) {
+        latencies.record(message, TscClock::ticks());
+    }
+
+    void shutdown() { buffer_.shutdown(); }
+    size_t size() const { return buffer_.size(); }
+    bool empty() const { return buffer_.empty(); }
+    size_t capacity() const { return buffer_.capacity(); }
+};
+
+#endif // PRODUCER_CONSUMER_LATENCY_TRACE_H
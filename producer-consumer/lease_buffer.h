@@ -0,0 +1,254 @@
+#ifndef PRODUCER_CONSUMER_LEASE_BUFFER_H
+#define PRODUCER_CONSUMER_LEASE_BUFFER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "atomics.h"
+#include "backoff.h"
+
+/**
+ * Lease/Ack Buffer (At-Least-Once Delivery)
+ *
+ * Buffer::pop removes an item before it is processed, so a consumer that
+ * throws halfway through loses it. LeaseBuffer hands out leases instead:
+ *
+ *   LeaseBuffer<Task>::Lease lease;
+ *   Task task;
+ *   if (buffer.pop(lease, task)) {
+ *       try { run(task); buffer.ack(lease); }      // done: slot is freed
+ *       catch (...) { buffer.nack(lease); }        // redeliver right away
+ *   }
+ *
+ * If a consumer neither acks nor nacks (it crashed, hung, or threw past
+ * its handler), the lease times out and the item is redelivered to
+ * whichever consumer polls next. An ack for an expired lease is rejected,
+ * so a slow consumer learns that its work is being redone.
+ *
+ * Every slot of a fixed ring carries its own atomic state word
+ * (generation + Empty/Writing/Ready/Claiming/Leased), so there is no global
+ * lock and no allocation per message; producers and consumers just CAS the
+ * state of the slot they are working on. The generation changes on every
+ * lease and on every extend(), which is what makes stale acks (and steals
+ * based on a deadline that has since moved) detectable.
+ *
+ * Delivery order is approximately FIFO (consumers scan from a rotating
+ * cursor), which is what a work queue with redelivery can promise anyway.
+ */
+template<typename T>
+class LeaseBuffer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Lease {
+        size_t slot = 0;
+        uint64_t generation = 0;
+        uint32_t attempt = 0;               // 1 on first delivery, 2+ on redelivery
+    };
+
+private:
+    enum State : uint64_t {
+        EMPTY = 0,
+        WRITING = 1,                        // Producer is filling the slot
+        READY = 2,                          // Waiting for a consumer
+        CLAIMING = 3,                       // Consumer is setting up its lease
+        LEASED = 4
+    };
+
+    static const uint64_t STATE_BITS = 3;
+    static const uint64_t STATE_MASK = (1u << STATE_BITS) - 1;
+
+    static uint64_t pack(uint64_t generation, State state) { return (generation << STATE_BITS) | state; }
+    static State state_of(uint64_t word) { return static_cast<State>(word & STATE_MASK); }
+    static uint64_t generation_of(uint64_t word) { return word >> STATE_BITS; }
+
+    struct alignas(64) Slot {
+        Atomic<uint64_t> word{pack(0, EMPTY)};
+        Atomic<int64_t> deadline{0};        // Lease expiry, steady_clock ticks
+        Atomic<uint32_t> attempts{0};
+        T item;
+    };
+
+    const size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    const Clock::duration lease_timeout_;
+
+    alignas(64) Atomic<size_t> producer_cursor_{0};
+    alignas(64) Atomic<size_t> consumer_cursor_{0};
+    alignas(64) Atomic<size_t> outstanding_{0};        // Pushed but not yet acked
+    Atomic<bool> shutdown_{false};
+    Atomic<uint64_t> redeliveries_{0};
+    Atomic<uint64_t> expired_{0};
+
+    static int64_t now() { return Clock::now().time_since_epoch().count(); }
+
+    // Ready -> Leased, or an expired Leased -> Leased (stolen)
+    bool try_lease(size_t index, Lease& lease, T& item) {
+        Slot& slot = slots_[index];
+        uint64_t word = slot.word.load(std::memory_order_acquire);
+        State state = state_of(word);
+        if (state == LEASED) {
+            if (slot.deadline.load(std::memory_order_relaxed) > now()) {
+                return false;
+            }
+        } else if (state != READY) {
+            return false;
+        }
+
+        uint64_t generation = generation_of(word) + 1;
+        if (!slot.word.compare_exchange_strong(word, pack(generation, CLAIMING), std::memory_order_acq_rel)) {
+            return false;
+        }
+        if (state == LEASED) {
+            expired_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // The slot is ours while CLAIMING: nobody else reads the deadline
+        slot.deadline.store((Clock::now() + lease_timeout_).time_since_epoch().count(),
+                            std::memory_order_relaxed);
+        uint32_t attempt = slot.attempts.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (attempt > 1) {
+            redeliveries_.fetch_add(1, std::memory_order_relaxed);
+        }
+        PC_MODEL_READ(&slot.item);
+        item = slot.item;                   // Copy: the slot keeps it for redelivery
+        slot.word.store(pack(generation, LEASED), std::memory_order_release);
+
+        lease.slot = index;
+        lease.generation = generation;
+        lease.attempt = attempt;
+        return true;
+    }
+
+public:
+    // A capacity of 0 is raised to 1: slot lookups are taken modulo capacity
+    explicit LeaseBuffer(size_t capacity = 64,
+                         Clock::duration lease_timeout = std::chrono::milliseconds(100))
+        : capacity_(capacity < 1 ? 1 : capacity), slots_(new Slot[capacity_]), lease_timeout_(lease_timeout) {}
+
+    LeaseBuffer(const LeaseBuffer&) = delete;
+    LeaseBuffer& operator=(const LeaseBuffer&) = delete;
+
+    bool try_push(T item) {
+        if (shutdown_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        size_t start = producer_cursor_.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < capacity_; ++i) {
+            size_t index = (start + i) % capacity_;
+            Slot& slot = slots_[index];
+            uint64_t word = slot.word.load(std::memory_order_relaxed);
+            if (state_of(word) != EMPTY) {
+                continue;
+            }
+            if (slot.word.compare_exchange_strong(word, pack(generation_of(word), WRITING),
+                                                  std::memory_order_acquire)) {
+                PC_MODEL_WRITE(&slot.item);
+                slot.item = std::move(item);
+                slot.attempts.store(0, std::memory_order_relaxed);
+                outstanding_.fetch_add(1, std::memory_order_relaxed);
+                slot.word.store(pack(generation_of(word), READY), std::memory_order_release);
+                return true;
+            }
+        }
+        return false;                       // Every slot is in use
+    }
+
+    // Blocks while every slot is in use. Returns false after shutdown().
+    bool push(T item) {
+        Backoff backoff;
+        while (!shutdown_.load(std::memory_order_acquire)) {
+            if (try_push(item)) {
+                return true;
+            }
+            backoff.pause();
+        }
+        return false;
+    }
+
+    // Leases a ready (or expired) item without blocking
+    bool try_pop(Lease& lease, T& item) {
+        size_t start = consumer_cursor_.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (try_lease((start + i) % capacity_, lease, item)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Blocks until an item can be leased. Returns false once the buffer is
+    // shut down and every item has been acknowledged; until then, leases that
+    // expire are still redelivered.
+    bool pop(Lease& lease, T& item) {
+        Backoff backoff;
+        for (;;) {
+            if (try_pop(lease, item)) {
+                return true;
+            }
+            if (shutdown_.load(std::memory_order_acquire) && outstanding_.load(std::memory_order_acquire) == 0) {
+                return false;
+            }
+            backoff.pause();
+        }
+    }
+
+    // Processing finished: frees the slot. Returns false if the lease had
+    // already expired and the item was handed to another consumer.
+    bool ack(const Lease& lease) {
+        Slot& slot = slots_[lease.slot];
+        uint64_t expected = pack(lease.generation, LEASED);
+        if (!slot.word.compare_exchange_strong(expected, pack(lease.generation, WRITING),
+                                               std::memory_order_acquire)) {
+            return false;
+        }
+        PC_MODEL_WRITE(&slot.item);
+        slot.item = T();                    // Release what the item holds now, not on the next push
+        slot.word.store(pack(lease.generation, EMPTY), std::memory_order_release);
+        outstanding_.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    // Processing failed: makes the item available again immediately
+    bool nack(const Lease& lease) {
+        Slot& slot = slots_[lease.slot];
+        uint64_t expected = pack(lease.generation, LEASED);
+        return slot.word.compare_exchange_strong(expected, pack(lease.generation, READY),
+                                                 std::memory_order_release);
+    }
+
+    // Pushes the lease deadline out for long-running work (by the buffer's
+    // lease timeout, or by `timeout`). The lease gets a new generation, so a
+    // consumer that read the old, expired deadline can no longer steal it;
+    // `lease` is updated and must be used for the ack.
+    bool extend(Lease& lease) { return extend(lease, lease_timeout_); }
+
+    bool extend(Lease& lease, Clock::duration timeout) {
+        Slot& slot = slots_[lease.slot];
+        uint64_t expected = pack(lease.generation, LEASED);
+        uint64_t generation = lease.generation + 1;
+        if (!slot.word.compare_exchange_strong(expected, pack(generation, CLAIMING),
+                                               std::memory_order_acquire)) {
+            return false;
+        }
+        slot.deadline.store((Clock::now() + timeout).time_since_epoch().count(),
+                            std::memory_order_relaxed);
+        slot.word.store(pack(generation, LEASED), std::memory_order_release);
+        lease.generation = generation;
+        return true;
+    }
+
+    void shutdown() { shutdown_.store(true, std::memory_order_release); }
+
+    // Items pushed but not yet acknowledged (queued or leased)
+    size_t outstanding() const { return outstanding_.load(std::memory_order_acquire); }
+
+    uint64_t redeliveries() const { return redeliveries_.load(std::memory_order_relaxed); }
+    uint64_t expired_leases() const { return expired_.load(std::memory_order_relaxed); }
+    size_t capacity() const { return capacity_; }
+};
+
+#endif // PRODUCER_CONSUMER_LEASE_BUFFER_H
@@ -0,0 +1,94 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lease_buffer.h"
+
+/**
+ * Lease/Ack Buffer Demo
+ *
+ * Three consumers process 30 tasks with at-least-once semantics:
+ * - Consumer 1 is reliable
+ * - Consumer 2 fails every 4th task with an exception and nacks it, so the
+ *   task is redelivered immediately
+ * - Consumer 3 crashes (its thread exits) in the middle of its 3rd task
+ *   without acking; the lease times out and another consumer picks it up
+ * At the end, every task has been completed even though two consumers
+ * misbehaved.
+ */
+
+const int NUM_TASKS = 30;
+
+std::mutex cout_mutex;
+
+void log(const std::string& line) {
+    std::lock_guard<std::mutex> lock(cout_mutex);
+    std::cout << line << "\n";
+}
+
+int main() {
+    std::cout << "\n=== LEASE/ACK BUFFER DEMO ===\n";
+
+    LeaseBuffer<std::string> buffer(16, std::chrono::milliseconds(100));
+    std::atomic<int> completed[NUM_TASKS] = {};
+
+    auto consumer = [&](int id) {
+        LeaseBuffer<std::string>::Lease lease;
+        std::string task;
+        int handled = 0;
+        while (buffer.pop(lease, task)) {
+            handled++;
+            std::string who = "[CONSUMER " + std::to_string(id) + "] ";
+            try {
+                if (id == 3 && handled == 3) {
+                    log(who + "Crashing while holding '" + task + "' (no ack)");
+                    return;
+                }
+                if (id == 2 && handled % 4 == 0) {
+                    throw std::runtime_error("transient failure");
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                int index = std::stoi(task.substr(task.find('_') + 1));
+                if (buffer.ack(lease)) {
+                    completed[index]++;
+                    if (lease.attempt > 1) {
+                        log(who + "Completed '" + task + "' on attempt " + std::to_string(lease.attempt));
+                    }
+                }
+            } catch (const std::exception& e) {
+                log(who + "Failed '" + task + "' (" + e.what() + "), nack");
+                buffer.nack(lease);
+            }
+        }
+    };
+
+    std::vector<std::thread> consumers;
+    for (int id = 1; id <= 3; ++id) {
+        consumers.emplace_back(consumer, id);
+    }
+
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        buffer.push("Task_" + std::to_string(i));
+    }
+    buffer.shutdown();
+
+    for (auto& thread : consumers) {
+        thread.join();
+    }
+
+    int done = 0;
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        done += completed[i].load() > 0 ? 1 : 0;
+    }
+    std::cout << "\n[MAIN] Tasks completed: " << done << "/" << NUM_TASKS << ", redeliveries: "
+              << buffer.redeliveries() << ", expired leases: " << buffer.expired_leases() << "\n";
+    std::cout << "=== LEASE/ACK DEMO COMPLETED ===\n\n";
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+#ifndef PRODUCER_CONSUMER_LOCK_PROFILER_H
+#define PRODUCER_CONSUMER_LOCK_PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "hdr_histogram.h"
+#include "tsc_clock.h"
+
+/**
+ * Lock Contention Profiler
+ *
+ * "The mutex is the bottleneck" is a guess until it has numbers attached.
+ * ProfiledMutex is a drop-in std::mutex replacement that records, per call
+ * site:
+ * - acquisitions, and how many were contended (try_lock failed first)
+ * - wait time: from asking for the lock to getting it
+ * - hold time: from getting the lock to releasing it
+ *
+ * A call site is named with PC_LOCK_SITE("Buffer::push") at the top of the
+ * function; every lock taken on that thread until the end of the scope,
+ * including re-locks inside condition variable waits, is charged to it.
+ * Sites with the same name share statistics across all instances.
+ * Waits and holds go into ConcurrentHistograms, so profiling adds no lock
+ * of its own. A summary table is printed to stderr at exit.
+ *
+ * Buffer switches to ProfiledMutex (and std::condition_variable_any) when
+ * built with PRODUCER_CONSUMER_LOCK_PROFILE; otherwise PC_LOCK_SITE
+ * compiles to nothing and Buffer keeps a plain std::mutex.
+ */
+
+struct LockSiteStats {
+    std::string name;
+    std::atomic<uint64_t> contended{0};
+    ConcurrentHistogram wait;               // ns; count() is the number of acquisitions
+    ConcurrentHistogram hold;               // ns
+
+    explicit LockSiteStats(std::string site) : name(std::move(site)) {}
+};
+
+class LockProfiler {
+private:
+    std::mutex mutex_;                      // Only for registering sites
+    std::map<std::string, std::unique_ptr<LockSiteStats>> sites_;
+    bool report_at_exit_ = true;
+
+    LockProfiler() { TscClock::instance(); }
+
+    ~LockProfiler() {
+        if (report_at_exit_ && !sites_.empty()) {
+            std::fflush(stdout);            // Keep the report after the program's own output
+            std::fputs(report().c_str(), stderr);
+        }
+    }
+
+    static LockSiteStats*& current() {
+        thread_local LockSiteStats* site = nullptr;
+        return site;
+    }
+
+public:
+    static LockProfiler& instance() {
+        static LockProfiler profiler;
+        return profiler;
+    }
+
+    // Registers a call site once; the result is kept in a static at the site
+    LockSiteStats& site(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& entry = sites_[name];
+        if (!entry) {
+            entry = std::make_unique<LockSiteStats>(name);
+        }
+        return *entry;
+    }
+
+    // Where the calling thread's next lock() is charged
+    static LockSiteStats& active() {
+        LockSiteStats* site = current();
+        if (site == nullptr) {
+            static LockSiteStats& unattributed = instance().site("(unattributed)");
+            return unattributed;
+        }
+        return *site;
+    }
+
+    // Marks the calling thread as inside a call site until destroyed
+    class Scope {
+    private:
+        LockSiteStats* previous_;
+
+    public:
+        explicit Scope(LockSiteStats& site) : previous_(current()) { current() = &site; }
+        ~Scope() { current() = previous_; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    void set_report_at_exit(bool enabled) { report_at_exit_ = enabled; }
+
+    // One row per site; times in microseconds
+    std::string report() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string out = "\n=== LOCK PROFILE ===\n";
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-22s %10s %10s %9s %9s %9s %9s %9s %9s\n", "site", "acquired",
+                      "contended", "wait p50", "wait p99", "wait max", "hold p50", "hold p99", "hold max");
+        out += line;
+        for (const auto& entry : sites_) {
+            const LockSiteStats& site = *entry.second;
+            HdrHistogram wait = site.wait.snapshot();
+            HdrHistogram hold = site.hold.snapshot();
+            if (wait.count() == 0) {
+                continue;
+            }
+            double contended = 100.0 * static_cast<double>(site.contended.load(std::memory_order_relaxed)) /
+                               static_cast<double>(wait.count());
+            std::snprintf(line, sizeof(line), "%-22s %10llu %9.1f%% %9.2f %9.2f %9.1f %9.2f %9.2f %9.1f\n",
+                          site.name.c_str(), static_cast<unsigned long long>(wait.count()), contended,
+                          wait.percentile(50) / 1000.0, wait.percentile(99) / 1000.0, wait.max() / 1000.0,
+                          hold.percentile(50) / 1000.0, hold.percentile(99) / 1000.0, hold.max() / 1000.0);
+            out += line;
+        }
+        out += "(times in us; acquisitions include re-locks after condition variable waits)\n";
+        return out;
+    }
+};
+
+// std::mutex with per-call-site contention statistics. Meets the Lockable
+// requirements, so it works with lock_guard, unique_lock and
+// condition_variable_any.
+class ProfiledMutex {
+private:
+    std::mutex mutex_;
+    uint64_t acquired_at_ = 0;              // Protected by mutex_
+    LockSiteStats* holder_ = nullptr;       // Protected by mutex_
+
+    void acquired(LockSiteStats& site, uint64_t requested) {
+        acquired_at_ = TscClock::ticks();
+        holder_ = &site;
+        site.wait.record(TscClock::instance().to_ns(acquired_at_ - requested));
+    }
+
+public:
+    void lock() {
+        LockSiteStats& site = LockProfiler::active();
+        uint64_t requested = TscClock::ticks();
+        if (!mutex_.try_lock()) {
+            site.contended.fetch_add(1, std::memory_order_relaxed);
+            mutex_.lock();
+        }
+        acquired(site, requested);
+    }
+
+    bool try_lock() {
+        uint64_t requested = TscClock::ticks();
+        if (!mutex_.try_lock()) {
+            return false;
+        }
+        acquired(LockProfiler::active(), requested);
+        return true;
+    }
+
+    void unlock() {
+        LockSiteStats* site = holder_;
+        uint64_t held = TscClock::ticks() - acquired_at_;
+        mutex_.unlock();
+        site->hold.record(TscClock::instance().to_ns(held));
+    }
+};
+
+#define PC_LOCK_CONCAT_(a, b) a##b
+#define PC_LOCK_CONCAT(a, b) PC_LOCK_CONCAT_(a, b)
+
+#ifdef PRODUCER_CONSUMER_LOCK_PROFILE
+#define PC_LOCK_SITE(name)                                                                          \
+    static LockSiteStats& PC_LOCK_CONCAT(lock_site_, __LINE__) = LockProfiler::instance().site(name); \
+    LockProfiler::Scope PC_LOCK_CONCAT(lock_scope_, __LINE__)(PC_LOCK_CONCAT(lock_site_, __LINE__))
+#else
+#define PC_LOCK_SITE(name) ((void)0)
+#endif
+
+#endif // PRODUCER_CONSUMER_LOCK_PROFILER_H
@@ -0,0 +1,781 @@
+#ifndef PRODUCER_CONSUMER_MODEL_CHECK_H
+#define PRODUCER_CONSUMER_MODEL_CHECK_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ucontext.h>
+
+/**
+ * Deterministic Schedule Exploration (Model Checking)
+ *
+ * A stress test only sees the interleavings the OS happens to produce, and
+ * on x86 it never sees most weak-memory reorderings at all. A memory-order
+ * bug in a lock-free queue can therefore pass millions of stress rounds.
+ * ModelChecker runs a small scenario over and over under full control, in
+ * the style of Relacy and CDSChecker:
+ *
+ *   struct TwoProducers {
+ *       RingBuffer<int> queue{2};          // Set up before the threads run
+ *       void thread(int id) { ... }        // Body of model thread `id`
+ *       void verify() { ... }              // After all threads finished
+ *   };
+ *   ModelChecker::Result result = ModelChecker::check<TwoProducers>(3);
+ *
+ * - Model threads are fibers (ucontext) on one OS thread, so exactly one
+ *   runs at a time and only the checker decides who runs next
+ * - Every operation on an instrumented atomic (ModelAtomic<T>, what
+ *   Atomic<T> in atomics.h becomes under PRODUCER_CONSUMER_MODEL_CHECK) is
+ *   a scheduling point
+ * - Weak memory: each atomic keeps its whole modification order, and a load
+ *   may return any store that C++ allows it to see. Happens-before is
+ *   tracked with vector clocks: acquire loads that read a release store (or
+ *   a release sequence continued by RMWs) join the writer's clock. Loads
+ *   never go back past what the thread has already observed, or past a
+ *   store or read that happens-before them (coherence). RMWs and seq_cst
+ *   loads read the latest store
+ * - Plain accesses marked with PC_MODEL_READ/PC_MODEL_WRITE are checked
+ *   for data races against the same clocks. That is how a missing acquire
+ *   shows up: the consumer reads the slot without happening-after the write
+ * - Backoff::pause() tells the checker the thread is spinning. It is
+ *   descheduled until some other thread stores, so spin loops do not make
+ *   the search infinite. A thread that spun on a stale value is first
+ *   forced to read the newest values, because real hardware eventually
+ *   shows it those
+ *
+ * Every run records its choices (which thread runs, which store a load
+ * reads). The next run replays a prefix and takes the next alternative, a
+ * depth-first search that is exhaustive once it runs out of alternatives.
+ * Like CHESS, it bounds preemptions (switching away from a thread that
+ * could have continued), and likewise the number of stale reads (loads that
+ * skip the newest store); most concurrency bugs need only one or two of
+ * each. Setting random_executions switches to random walks for larger
+ * scenarios.
+ *
+ * A failed check stops the search and returns the schedule's last events.
+ * A failure is a data race, a deadlock (every thread waiting), a livelock
+ * (max_steps exceeded), a ModelFailure thrown by the scenario (see
+ * model_assert), or any other exception escaping a thread.
+ *
+ * Not modeled: fences, spurious compare_exchange_weak failures, and reads
+ * from stores that are not yet in modification order (out-of-thin-air).
+ * Scenarios must be deterministic apart from what the checker controls.
+ */
+
+class ModelFailure : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class ModelChecker {
+public:
+    static constexpr int MAX_THREADS = 8;
+    using Clock = std::array<uint32_t, MAX_THREADS>;   // Vector clock, one epoch per thread
+
+    struct Options {
+        int max_preemptions = 2;            // Negative: unbounded
+        int max_stale_reads = 1;            // Loads per execution that skip the newest store; negative: unbounded
+        uint64_t max_executions = 1000000;  // Stop the search here (result is then not exhaustive)
+        uint64_t max_steps = 100000;        // Scheduling points per execution before "livelock"
+        uint64_t random_executions = 0;     // Non-zero: random walks instead of the exhaustive search
+        uint64_t seed = 1;
+    };
+
+    struct Result {
+        bool passed = true;
+        bool exhaustive = false;            // Every schedule within the bounds was run
+        uint64_t executions = 0;
+        std::string failure;
+        std::string trace;                  // Last events of the failing execution
+    };
+
+private:
+    static constexpr size_t STACK_SIZE = 256 * 1024;
+    static constexpr size_t TRACE_EVENTS = 48;
+
+    struct Thread {
+        ucontext_t context;
+        std::unique_ptr<char[]> stack;
+        Clock clock{};
+        bool finished = false;
+        uint64_t stores = 0;                // Stores by this thread
+        uint64_t others_at_spin = 0;        // Stores by other threads at its last spin
+        bool waiting = false;               // Spinning until another thread stores
+        bool read_stale = false;            // Some load since the last spin did not read the newest store
+        bool read_latest = false;           // Forced after spinning on a stale value
+        uint32_t yields_to = 0;             // Threads that must run before it runs again, after a spin
+    };
+
+    struct Choice {
+        uint32_t taken;
+        uint32_t options;
+    };
+
+    struct Event {
+        int thread;
+        const char* what;
+        const void* address;
+        uint64_t value;
+    };
+
+    struct Shadow {                         // Last accesses to one plain memory location
+        int writer = -1;
+        uint32_t write_epoch = 0;
+        Clock reads{};                      // Epoch of each thread's last read, 0 = none
+    };
+
+    static ModelChecker*& active() {
+        static ModelChecker* checker = nullptr;
+        return checker;
+    }
+
+    const Options options_;
+    std::vector<Thread> threads_;
+    ucontext_t scheduler_;
+    void (*body_)(void*, int) = nullptr;
+    void* scenario_ = nullptr;
+
+    int current_ = -1;                      // Running thread; -1 outside an execution
+    int next_ = -1;
+    int preemptions_ = 0;
+    int stale_reads_ = 0;
+    uint64_t steps_ = 0;
+    uint64_t stores_ = 0;
+    bool failed_ = false;
+    std::string failure_;
+
+    std::vector<Choice> path_;              // Choices of the current execution
+    size_t depth_ = 0;                      // Choices replayed or made so far
+    std::mt19937_64 random_;
+
+    std::unordered_map<const void*, Shadow> shadow_;
+    std::vector<Event> events_;             // Ring of the last TRACE_EVENTS events
+    uint64_t event_count_ = 0;
+
+    ModelChecker(int threads, const Options& options)
+        : options_(options), threads_(static_cast<size_t>(threads)), random_(options.seed) {
+        if (threads < 1 || threads > MAX_THREADS) {
+            throw std::invalid_argument("ModelChecker supports 1 to 8 threads");
+        }
+        for (Thread& thread : threads_) {
+            thread.stack.reset(new char[STACK_SIZE]);
+        }
+    }
+
+    static void fiber_main() {
+        ModelChecker& checker = *active();
+        int id = checker.current_;
+        try {
+            checker.body_(checker.scenario_, id);
+        } catch (const ModelFailure& failure) {
+            checker.report(failure.what());
+        } catch (const std::exception& error) {
+            checker.report(std::string("thread ") + std::to_string(id) + " threw: " + error.what());
+        }
+        checker.threads_[static_cast<size_t>(id)].finished = true;
+        // Returning resumes the scheduler through uc_link
+    }
+
+    uint64_t stores_by_others(const Thread& thread) const { return stores_ - thread.stores; }
+
+    bool runnable(int id) {
+        Thread& thread = threads_[static_cast<size_t>(id)];
+        if (thread.finished) {
+            return false;
+        }
+        if (thread.waiting && stores_by_others(thread) > thread.others_at_spin) {
+            thread.waiting = false;         // Someone stored: look again
+            thread.others_at_spin = stores_by_others(thread);
+        }
+        return !thread.waiting;
+    }
+
+    uint32_t choose(uint32_t options) {
+        if (options <= 1) {
+            return 0;
+        }
+        if (options_.random_executions > 0) {
+            return static_cast<uint32_t>(random_() % options);
+        }
+        if (depth_ < path_.size()) {
+            const Choice& choice = path_[depth_++];
+            if (choice.options != options) {
+                throw ModelFailure("scenario is not deterministic: replay diverged");
+            }
+            return choice.taken;
+        }
+        path_.push_back({0, options});
+        depth_++;
+        return 0;
+    }
+
+    uint32_t runnable_mask(int except) {
+        uint32_t mask = 0;
+        for (int id = 0; id < static_cast<int>(threads_.size()); ++id) {
+            if (id != except && runnable(id)) {
+                mask |= 1u << id;
+            }
+        }
+        return mask;
+    }
+
+    // Next thread to run. `preferred` (the running thread, if it could go
+    // on) comes first; picking another one is a preemption.
+    //
+    // Scheduling is fair, as in CHESS: a thread that spun may only run again
+    // once the threads that were runnable at that point have run. Otherwise
+    // the search would follow schedules in which spinning threads keep each
+    // other busy forever while the thread they wait for never runs.
+    int pick(int preferred) {
+        uint32_t runnable = runnable_mask(-1);
+        if (runnable == 0) {
+            bool all_finished = std::all_of(threads_.begin(), threads_.end(),
+                                            [](const Thread& thread) { return thread.finished; });
+            if (!all_finished) {
+                report("deadlock: every unfinished thread is waiting for a store that never comes");
+            }
+            return -1;
+        }
+        uint32_t eligible = 0;
+        for (int id = 0; id < static_cast<int>(threads_.size()); ++id) {
+            if ((runnable >> id & 1u) != 0 && (threads_[static_cast<size_t>(id)].yields_to & runnable) == 0) {
+                eligible |= 1u << id;
+            }
+        }
+        if (eligible == 0) {
+            eligible = runnable;            // Everyone is yielding to someone: ignore it
+        }
+
+        std::array<int, MAX_THREADS> candidates;
+        uint32_t count = 0;
+        bool keep = preferred >= 0 && (eligible >> preferred & 1u) != 0;
+        if (keep) {
+            candidates[count++] = preferred;
+        }
+        if (!keep || options_.max_preemptions < 0 || preemptions_ < options_.max_preemptions) {
+            for (int id = 0; id < static_cast<int>(threads_.size()); ++id) {
+                if (id != preferred && (eligible >> id & 1u) != 0) {
+                    candidates[count++] = id;
+                }
+            }
+        }
+        uint32_t index = choose(count);
+        if (keep && index > 0) {
+            preemptions_++;
+        }
+        int next = candidates[index];
+        for (Thread& thread : threads_) {
+            thread.yields_to &= ~(1u << next);
+        }
+        return next;
+    }
+
+    // Inside a fiber: hand control to `next` (possibly the same thread)
+    void switch_to(int next) {
+        if (next == current_) {
+            return;
+        }
+        next_ = next;
+        swapcontext(&threads_[static_cast<size_t>(current_)].context, &scheduler_);
+    }
+
+    void report(const std::string& failure) {
+        if (!failed_) {
+            failed_ = true;
+            failure_ = failure;
+        }
+    }
+
+    void run_execution() {
+        for (Thread& thread : threads_) {
+            thread.clock.fill(0);
+            thread.finished = false;
+            thread.stores = 0;
+            thread.others_at_spin = 0;
+            thread.waiting = false;
+            thread.read_stale = false;
+            thread.read_latest = false;
+            thread.yields_to = 0;
+            getcontext(&thread.context);
+            thread.context.uc_stack.ss_sp = thread.stack.get();
+            thread.context.uc_stack.ss_size = STACK_SIZE;
+            thread.context.uc_link = &scheduler_;
+            makecontext(&thread.context, fiber_main, 0);
+        }
+        preemptions_ = 0;
+        stale_reads_ = 0;
+        steps_ = 0;
+        stores_ = 0;
+        failed_ = false;
+        failure_.clear();
+        depth_ = 0;
+        shadow_.clear();
+        events_.clear();
+        event_count_ = 0;
+
+        int next = -1;
+        try {
+            next = pick(-1);
+        } catch (const ModelFailure& failure) {
+            report(failure.what());
+        }
+        while (next >= 0 && !failed_) {
+            current_ = next;
+            next_ = -1;
+            swapcontext(&scheduler_, &threads_[static_cast<size_t>(next)].context);
+            if (failed_) {
+                break;
+            }
+            if (threads_[static_cast<size_t>(current_)].finished) {
+                try {
+                    next = pick(-1);
+                } catch (const ModelFailure& failure) {
+                    report(failure.what());
+                }
+            } else {
+                next = next_;
+            }
+        }
+        current_ = -1;
+    }
+
+    // Moves the search to the next unexplored schedule
+    bool advance() {
+        while (!path_.empty() && path_.back().taken + 1 >= path_.back().options) {
+            path_.pop_back();
+        }
+        if (path_.empty()) {
+            return false;
+        }
+        path_.back().taken++;
+        return true;
+    }
+
+    std::string describe() const {
+        std::string text;
+        uint64_t first = event_count_ > TRACE_EVENTS ? event_count_ - TRACE_EVENTS : 0;
+        for (uint64_t i = first; i < event_count_; ++i) {
+            const Event& event = events_[static_cast<size_t>(i % TRACE_EVENTS)];
+            char line[128];
+            std::snprintf(line, sizeof(line), "  #%-5llu thread %d  %-10s %p  %llu\n",
+                          static_cast<unsigned long long>(i), event.thread, event.what, event.address,
+                          static_cast<unsigned long long>(event.value));
+            text += line;
+        }
+        return text;
+    }
+
+    [[noreturn]] void fail(const std::string& failure) {
+        report(failure);
+        throw ModelFailure(failure);
+    }
+
+public:
+    // Runs the search. Scenario must be default-constructible and provide
+    // thread(int id) for ids 0..threads-1 and verify().
+    template<typename Scenario>
+    static Result check(int threads, const Options& options = Options()) {
+        ModelChecker checker(threads, options);
+        checker.body_ = [](void* scenario, int id) { static_cast<Scenario*>(scenario)->thread(id); };
+        active() = &checker;
+
+        Result result;
+        for (;;) {
+            {
+                Scenario scenario;
+                checker.scenario_ = &scenario;
+                checker.run_execution();
+                result.executions++;
+                if (!checker.failed_) {
+                    try {
+                        scenario.verify();
+                    } catch (const ModelFailure& failure) {
+                        checker.report(failure.what());
+                    }
+                }
+            }
+            if (checker.failed_) {
+                result.passed = false;
+                result.failure = checker.failure_;
+                result.trace = checker.describe();
+                break;
+            }
+            if (options.random_executions > 0) {
+                if (result.executions >= options.random_executions) {
+                    break;
+                }
+            } else if (!checker.advance()) {
+                result.exhaustive = true;
+                break;
+            } else if (result.executions >= options.max_executions) {
+                break;
+            }
+        }
+        active() = nullptr;
+        return result;
+    }
+
+    // The checker driving the calling model thread, or nullptr outside one
+    static ModelChecker* running() {
+        ModelChecker* checker = active();
+        return checker != nullptr && checker->current_ >= 0 ? checker : nullptr;
+    }
+
+    // --- Hooks for ModelAtomic, Backoff and PC_MODEL_READ/WRITE ---
+
+    // Called before every atomic operation: the checker may switch threads
+    void schedule() {
+        if (++steps_ > options_.max_steps) {
+            fail("livelock: no thread finished within " + std::to_string(options_.max_steps) + " steps");
+        }
+        int next = pick(current_);
+        switch_to(next);
+    }
+
+    // New epoch for the running thread; returns its clock
+    Clock& tick() {
+        Clock& clock = threads_[static_cast<size_t>(current_)].clock;
+        clock[static_cast<size_t>(current_)]++;
+        return clock;
+    }
+
+    int thread() const { return current_; }
+
+    // Which of `options` stores a load reads: 0 is the newest
+    uint32_t choose_store(uint32_t options) {
+        Thread& thread = threads_[static_cast<size_t>(current_)];
+        if (thread.read_latest || (options_.max_stale_reads >= 0 && stale_reads_ >= options_.max_stale_reads)) {
+            return 0;
+        }
+        uint32_t choice = choose(options);
+        if (choice > 0) {
+            thread.read_stale = true;
+            stale_reads_++;
+        }
+        return choice;
+    }
+
+    void stored() {
+        stores_++;
+        threads_[static_cast<size_t>(current_)].stores++;
+    }
+
+    // Backoff::pause() in a spin loop. If the last iteration read only the
+    // newest values and nobody else stored meanwhile, the next one would do
+    // exactly the same: park the thread until another thread stores.
+    void spin() {
+        Thread& thread = threads_[static_cast<size_t>(current_)];
+        bool stale = thread.read_stale;
+        bool changed = stores_by_others(thread) > thread.others_at_spin;
+        thread.others_at_spin = stores_by_others(thread);
+        // A loop waiting on a value it read stale retries with the newest ones
+        thread.read_latest = stale;
+        thread.read_stale = false;
+        thread.yields_to = runnable_mask(current_);
+        if (stale || changed) {
+            schedule();
+            return;
+        }
+        thread.waiting = true;
+        int next = pick(-1);
+        if (next < 0) {
+            throw ModelFailure(failure_);
+        }
+        switch_to(next);
+    }
+
+    void trace(const char* what, const void* address, uint64_t value) {
+        Event event{current_, what, address, value};
+        if (events_.size() < TRACE_EVENTS) {
+            events_.push_back(event);
+        } else {
+            events_[static_cast<size_t>(event_count_ % TRACE_EVENTS)] = event;
+        }
+        event_count_++;
+    }
+
+    // Plain (non-atomic) access to `address`, checked for data races
+    void access(const void* address, bool write) {
+        Clock& clock = tick();
+        int self = current_;
+        Shadow& shadow = shadow_[address];
+        trace(write ? "write" : "read", address, 0);
+        if (shadow.writer >= 0 && shadow.writer != self &&
+            shadow.write_epoch > clock[static_cast<size_t>(shadow.writer)]) {
+            fail("data race on " + pointer(address) + ": thread " + std::to_string(self) +
+                 (write ? " writes" : " reads") + " what thread " + std::to_string(shadow.writer) +
+                 " wrote without happening-after it");
+        }
+        if (write) {
+            for (int other = 0; other < static_cast<int>(threads_.size()); ++other) {
+                size_t index = static_cast<size_t>(other);
+                if (other != self && shadow.reads[index] > clock[index]) {
+                    fail("data race on " + pointer(address) + ": thread " + std::to_string(self) +
+                         " overwrites what thread " + std::to_string(other) +
+                         " read without happening-after the read");
+                }
+            }
+            shadow.writer = self;
+            shadow.write_epoch = clock[static_cast<size_t>(self)];
+            shadow.reads.fill(0);
+        } else {
+            shadow.reads[static_cast<size_t>(self)] = clock[static_cast<size_t>(self)];
+        }
+    }
+
+    // Memory at `address` was freed; a later allocation there is unrelated
+    void release(const void* address) { shadow_.erase(address); }
+
+    static std::string pointer(const void* address) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%p", address);
+        return text;
+    }
+
+    static void join(Clock& into, const Clock& from) {
+        for (size_t i = 0; i < into.size(); ++i) {
+            into[i] = std::max(into[i], from[i]);
+        }
+    }
+};
+
+// Throws a ModelFailure (reported with the schedule that led to it) unless `condition` holds
+inline void model_assert(bool condition, const std::string& message) {
+    if (!condition) {
+        throw ModelFailure(message);
+    }
+}
+
+// std::atomic<T> look-alike whose operations the checker schedules and whose
+// loads may return any store the C++ memory model allows
+template<typename T>
+class ModelAtomic {
+private:
+    using Clock = ModelChecker::Clock;
+
+    struct Store {
+        T value;
+        int thread;                         // -1: initial value, visible to everyone
+        uint32_t epoch;
+        bool releases;                      // Acquiring this store synchronizes with `release`
+        Clock release;
+    };
+
+    // Loads record what they observed, so even const ones change these
+    mutable std::vector<Store> history_;    // Modification order, oldest first
+    // Per thread: (epoch, index) each time it observed a newer store
+    mutable std::array<std::vector<std::pair<uint32_t, size_t>>, ModelChecker::MAX_THREADS> observed_;
+
+    static bool acquires(std::memory_order order) {
+        return order == std::memory_order_acquire || order == std::memory_order_acq_rel ||
+               order == std::memory_order_seq_cst || order == std::memory_order_consume;
+    }
+
+    static bool releases(std::memory_order order) {
+        return order == std::memory_order_release || order == std::memory_order_acq_rel ||
+               order == std::memory_order_seq_cst;
+    }
+
+    static std::memory_order failure_order(std::memory_order order) {
+        if (order == std::memory_order_acq_rel) {
+            return std::memory_order_acquire;
+        }
+        return order == std::memory_order_release ? std::memory_order_relaxed : order;
+    }
+
+    static uint64_t trace_value(const T& value) {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            return static_cast<uint64_t>(value);
+        } else if constexpr (std::is_pointer_v<T>) {
+            return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+        } else {
+            return 0;
+        }
+    }
+
+    void observe(int thread, uint32_t epoch, size_t index) const {
+        auto& seen = observed_[static_cast<size_t>(thread)];
+        if (seen.empty() || seen.back().second < index) {
+            seen.emplace_back(epoch, index);
+        }
+    }
+
+    // Oldest store a load by a thread with `clock` may still read: the newest
+    // one observed by an access that happens-before the load
+    size_t oldest_visible(const Clock& clock) const {
+        size_t oldest = 0;
+        for (size_t thread = 0; thread < observed_.size(); ++thread) {
+            const auto& seen = observed_[thread];
+            auto after = std::upper_bound(seen.begin(), seen.end(), std::make_pair(clock[thread], SIZE_MAX));
+            if (after != seen.begin()) {
+                oldest = std::max(oldest, std::prev(after)->second);
+            }
+        }
+        return oldest;
+    }
+
+    // Reads store `index` on behalf of the running thread
+    const T& read(ModelChecker& checker, Clock& clock, size_t index, std::memory_order order) const {
+        observe(checker.thread(), clock[static_cast<size_t>(checker.thread())], index);
+        const Store& store = history_[index];
+        if (acquires(order) && store.releases) {
+            ModelChecker::join(clock, store.release);
+        }
+        return store.value;
+    }
+
+    // Appends a store by the running thread; `continues` is the store an RMW read
+    void write(ModelChecker& checker, Clock& clock, T value, std::memory_order order, const Store* continues) {
+        Store store{std::move(value), checker.thread(), clock[static_cast<size_t>(checker.thread())], false, Clock{}};
+        if (continues != nullptr && continues->releases) {
+            store.releases = true;          // An RMW extends the release sequence it read from
+            store.release = continues->release;
+        }
+        if (releases(order)) {
+            store.releases = true;
+            ModelChecker::join(store.release, clock);
+        }
+        history_.push_back(std::move(store));
+        observe(checker.thread(), clock[static_cast<size_t>(checker.thread())], history_.size() - 1);
+        checker.stored();
+    }
+
+    // Outside an execution (scenario setup and verify) there is no one to race with
+    void reset(T value) {
+        history_.assign(1, Store{std::move(value), -1, 0, false, Clock{}});
+        for (auto& seen : observed_) {
+            seen.clear();
+        }
+    }
+
+    template<typename F>
+    T read_modify_write(F modify, std::memory_order order) {
+        ModelChecker* checker = ModelChecker::running();
+        if (checker == nullptr) {
+            T previous = history_.back().value;
+            reset(modify(previous));
+            return previous;
+        }
+        checker->schedule();
+        Clock& clock = checker->tick();
+        Store latest = history_.back();
+        T previous = read(*checker, clock, history_.size() - 1, order);
+        write(*checker, clock, modify(previous), order, &latest);
+        checker->trace("rmw", this, trace_value(previous));
+        return previous;
+    }
+
+public:
+    ModelAtomic() : ModelAtomic(T()) {}
+
+    ModelAtomic(T value) {
+        ModelChecker* checker = ModelChecker::running();
+        if (checker == nullptr) {
+            reset(std::move(value));
+            return;
+        }
+        // Constructed by a model thread: only visible through happens-before
+        Clock& clock = checker->tick();
+        history_.push_back(Store{std::move(value), checker->thread(),
+                                 clock[static_cast<size_t>(checker->thread())], false, Clock{}});
+        observe(checker->thread(), history_.back().epoch, 0);
+    }
+
+    ModelAtomic(const ModelAtomic&) = delete;
+    ModelAtomic& operator=(const ModelAtomic&) = delete;
+
+    T load(std::memory_order order = std::memory_order_seq_cst) const {
+        ModelChecker* checker = ModelChecker::running();
+        if (checker == nullptr) {
+            return history_.back().value;
+        }
+        checker->schedule();
+        Clock& clock = checker->tick();
+        size_t newest = history_.size() - 1;
+        size_t index = newest;
+        if (order != std::memory_order_seq_cst) {
+            size_t oldest = oldest_visible(clock);
+            index = newest - checker->choose_store(static_cast<uint32_t>(newest - oldest + 1));
+        }
+        T value = read(*checker, clock, index, order);
+        checker->trace(index == newest ? "load" : "load-stale", this, trace_value(value));
+        return value;
+    }
+
+    void store(T value, std::memory_order order = std::memory_order_seq_cst) {
+        ModelChecker* checker = ModelChecker::running();
+        if (checker == nullptr) {
+            reset(std::move(value));
+            return;
+        }
+        checker->schedule();
+        Clock& clock = checker->tick();
+        checker->trace("store", this, trace_value(value));
+        write(*checker, clock, std::move(value), order, nullptr);
+    }
+
+    T exchange(T value, std::memory_order order = std::memory_order_seq_cst) {
+        return read_modify_write([&value](const T&) { return value; }, order);
+    }
+
+    bool compare_exchange_strong(T& expected, T desired, std::memory_order success,
+                                 std::memory_order failure) {
+        ModelChecker* checker = ModelChecker::running();
+        if (checker == nullptr) {
+            if (history_.back().value == expected) {
+                reset(std::move(desired));
+                return true;
+            }
+            expected = history_.back().value;
+            return false;
+        }
+        checker->schedule();
+        Clock& clock = checker->tick();
+        size_t newest = history_.size() - 1;
+        if (history_[newest].value == expected) {
+            Store latest = history_[newest];
+            read(*checker, clock, newest, success);
+            checker->trace("cas", this, trace_value(desired));
+            write(*checker, clock, std::move(desired), success, &latest);
+            return true;
+        }
+        expected = read(*checker, clock, newest, failure);
+        checker->trace("cas-fail", this, trace_value(expected));
+        return false;
+    }
+
+    bool compare_exchange_strong(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, std::move(desired), order, failure_order(order));
+    }
+
+    bool compare_exchange_weak(T& expected, T desired, std::memory_order success, std::memory_order failure) {
+        return compare_exchange_strong(expected, std::move(desired), success, failure);
+    }
+
+    bool compare_exchange_weak(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, std::move(desired), order, failure_order(order));
+    }
+
+    T fetch_add(T delta, std::memory_order order = std::memory_order_seq_cst) {
+        return read_modify_write([delta](const T& value) { return static_cast<T>(value + delta); }, order);
+    }
+
+    T fetch_sub(T delta, std::memory_order order = std::memory_order_seq_cst) {
+        return read_modify_write([delta](const T& value) { return static_cast<T>(value - delta); }, order);
+    }
+};
+
+#endif // PRODUCER_CONSUMER_MODEL_CHECK_H
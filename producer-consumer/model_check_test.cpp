@@ -0,0 +1,422 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "atomics.h"
+#include "backoff.h"
+#include "broadcast_ring.h"
+#include "lease_buffer.h"
+#include "model_check.h"
+#include "mpsc_queue.h"
+#include "ring_buffer.h"
+#include "spmc_ring.h"
+#include "spsc_ring.h"
+
+/**
+ * Model Check of the Lock-Free Queues
+ *
+ * Built with PRODUCER_CONSUMER_MODEL_CHECK, so every lock-free queue runs
+ * against the instrumented atomics of model_check.h. Each scenario is a few
+ * threads doing a few operations on a tiny queue (so wraparound, full and
+ * empty are all reached), and the checker runs every schedule and every
+ * permitted weak-memory outcome within the preemption bound. Each scenario
+ * then checks what a stress test would: exactly once, per-producer FIFO,
+ * clean shutdown. Data races on the payloads are caught by the checker
+ * itself.
+ *
+ * Two self-checks make sure the checker is not vacuous: a publication with
+ * a relaxed flag must be reported as a data race, and the store-buffering
+ * litmus test must reach its weak outcome (both threads read 0).
+ *
+ *   queue-model-check [--preemptions N] [--stale-reads N] [--random N] [--seed S]
+ *
+ * --random switches from the exhaustive search to N random schedules per
+ * scenario, for bigger bounds than the exhaustive search can finish. Exits
+ * with 1 if any scenario fails; registered with ctest.
+ */
+
+#ifndef PRODUCER_CONSUMER_MODEL_CHECK
+#error "model_check_test.cpp must be built with PRODUCER_CONSUMER_MODEL_CHECK"
+#endif
+
+// Two producers, one consumer, capacity 2: the third item waits for a free slot
+struct RingBufferMpmc {
+    RingBuffer<int> queue{2};
+    std::vector<int> popped;
+
+    void thread(int id) {
+        if (id == 0) {
+            queue.push(10);
+            queue.push(11);
+        } else if (id == 1) {
+            queue.push(20);
+        } else {
+            for (int i = 0; i < 3; ++i) {
+                int value = 0;
+                model_assert(queue.pop(value), "pop failed before shutdown");
+                popped.push_back(value);
+            }
+        }
+    }
+
+    void verify() {
+        std::vector<int> sorted = popped;
+        std::sort(sorted.begin(), sorted.end());
+        model_assert(sorted == std::vector<int>({10, 11, 20}), "items lost or duplicated");
+        auto first = std::find(popped.begin(), popped.end(), 10);
+        auto second = std::find(popped.begin(), popped.end(), 11);
+        model_assert(first < second, "producer 0's items out of order");
+    }
+};
+
+// Exactly-once delivery to two consumers, and pop() draining after shutdown
+template<typename Queue>
+struct OneProducerTwoConsumers {
+    Queue queue{2};
+    std::vector<int> popped[2];
+
+    void thread(int id) {
+        if (id == 0) {
+            for (int value = 1; value <= 3; ++value) {
+                queue.push(value);
+            }
+            queue.shutdown();
+        } else {
+            int value = 0;
+            while (queue.pop(value)) {
+                popped[id - 1].push_back(value);
+            }
+        }
+    }
+
+    void verify() {
+        std::vector<int> all;
+        for (const auto& consumer : popped) {
+            model_assert(std::is_sorted(consumer.begin(), consumer.end()), "consumer saw items out of order");
+            all.insert(all.end(), consumer.begin(), consumer.end());
+        }
+        std::sort(all.begin(), all.end());
+        model_assert(all == std::vector<int>({1, 2, 3}), "items lost or duplicated");
+    }
+};
+
+// Capacity 2 for the bounded queues; MpscQueue has no capacity
+template<typename Queue>
+Queue small_queue() {
+    return Queue(2);
+}
+
+template<>
+MpscQueue<int> small_queue<MpscQueue<int>>() {
+    return MpscQueue<int>();
+}
+
+// shutdown() from a third thread races a push: whatever push() accepted, pop() must deliver
+template<typename Queue>
+struct PushVersusShutdown {
+    Queue queue = small_queue<Queue>();
+    std::vector<int> accepted;
+    std::vector<int> popped;
+
+    void thread(int id) {
+        if (id == 0) {
+            for (int value = 1; value <= 2; ++value) {
+                if (queue.push(value)) {
+                    accepted.push_back(value);
+                }
+            }
+        } else if (id == 1) {
+            queue.shutdown();
+        } else {
+            int value = 0;
+            while (queue.pop(value)) {
+                popped.push_back(value);
+            }
+        }
+    }
+
+    void verify() { model_assert(popped == accepted, "an accepted push was never popped"); }
+};
+
+// One thread per side, capacity 2: the producer laps the consumer, then shuts down
+struct SpscOneEach {
+    SpscRing<int> queue{2};
+    std::vector<int> popped;
+
+    void thread(int id) {
+        if (id == 0) {
+            for (int value = 1; value <= 4; ++value) {
+                queue.push(value);
+            }
+            queue.shutdown();
+        } else {
+            int value = 0;
+            while (queue.pop(value)) {
+                popped.push_back(value);
+            }
+        }
+    }
+
+    void verify() { model_assert(popped == std::vector<int>({1, 2, 3, 4}), "items lost, duplicated or reordered"); }
+};
+
+// Two producers race on the head exchange; the consumer must wait out half-done pushes
+struct MpscTwoProducers {
+    MpscQueue<int> queue;
+    std::vector<int> popped;
+
+    void thread(int id) {
+        if (id < 2) {
+            queue.push(id * 10);
+            queue.push(id * 10 + 1);
+        } else {
+            for (int i = 0; i < 4; ++i) {
+                int value = 0;
+                model_assert(queue.pop(value), "pop failed before shutdown");
+                popped.push_back(value);
+            }
+            int extra = 0;
+            model_assert(!queue.try_pop(extra), "popped more than was pushed");
+        }
+    }
+
+    void verify() {
+        std::vector<int> sorted = popped;
+        std::sort(sorted.begin(), sorted.end());
+        model_assert(sorted == std::vector<int>({0, 1, 10, 11}), "items lost or duplicated");
+        for (int producer = 0; producer < 2; ++producer) {
+            auto first = std::find(popped.begin(), popped.end(), producer * 10);
+            auto second = std::find(popped.begin(), popped.end(), producer * 10 + 1);
+            model_assert(first < second, "a producer's items out of order");
+        }
+    }
+};
+
+// A two-stage pipeline on one ring: the second stage must see the first stage's field
+struct BroadcastTwoStages {
+    struct Entry {
+        int value = 0;
+        int doubled = 0;
+    };
+
+    BroadcastRing<Entry> ring{2};
+    BroadcastReader<Entry> first = ring.add_reader();
+    BroadcastReader<Entry> second = ring.add_reader({&first});
+    std::vector<int> seen;
+
+    void thread(int id) {
+        if (id == 0) {
+            for (int value = 1; value <= 3; ++value) {
+                ring.publish_with([value](Entry& entry) {
+                    entry.value = value;
+                    entry.doubled = 0;
+                });
+            }
+            ring.shutdown();
+        } else if (id == 1) {
+            while (first.update([](Entry& entry, int64_t) { entry.doubled = entry.value * 2; }) > 0) {
+            }
+        } else {
+            while (second.consume([this](const Entry& entry, int64_t) {
+                model_assert(entry.doubled == entry.value * 2, "second stage ran before the first");
+                seen.push_back(entry.value);
+            }) > 0) {
+            }
+        }
+    }
+
+    void verify() {
+        model_assert(seen == std::vector<int>({1, 2, 3}), "second stage missed or repeated entries");
+    }
+};
+
+// Leases are acked, so every item is delivered exactly once (no lease expires here)
+struct LeaseTwoConsumers {
+    LeaseBuffer<int> buffer{2, std::chrono::hours(1)};
+    std::vector<int> acked[2];
+
+    void thread(int id) {
+        if (id == 0) {
+            buffer.push(1);
+            buffer.push(2);
+            buffer.shutdown();
+        } else {
+            LeaseBuffer<int>::Lease lease;
+            int value = 0;
+            while (buffer.pop(lease, value)) {
+                model_assert(buffer.ack(lease), "ack of a live lease rejected");
+                acked[id - 1].push_back(value);
+            }
+        }
+    }
+
+    void verify() {
+        std::vector<int> all = acked[0];
+        all.insert(all.end(), acked[1].begin(), acked[1].end());
+        std::sort(all.begin(), all.end());
+        model_assert(all == std::vector<int>({1, 2}), "items lost or duplicated");
+        model_assert(buffer.outstanding() == 0, "outstanding count did not return to 0");
+    }
+};
+
+// Leases expire at once, so each thread may steal the other's. Once extend()
+// succeeds the lease runs for an hour: nobody may steal it, so the ack must win.
+// The losing schedule (steal checks the old deadline, extend, steal's CAS,
+// ack) needs three preemptions.
+struct LeaseExtendVersusSteal {
+    LeaseBuffer<int> buffer{1, std::chrono::nanoseconds(0)};
+    int acked = 0;
+
+    void thread(int id) {
+        if (id == 0) {
+            buffer.push(1);
+        }
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            LeaseBuffer<int>::Lease lease;
+            int value = 0;
+            if (buffer.try_pop(lease, value) && buffer.extend(lease, std::chrono::hours(1))) {
+                model_assert(buffer.ack(lease), "an extended lease was stolen");
+                acked++;
+                return;
+            }
+        }
+    }
+
+    void verify() {
+        model_assert(acked <= 1, "item acked twice");
+        model_assert(acked == 0 || buffer.outstanding() == 0, "outstanding count did not return to 0");
+    }
+};
+
+// Self-check: publishing with a relaxed store is a data race the checker must report
+struct RelaxedPublication {
+    Atomic<bool> ready{false};
+    int payload = 0;
+
+    void thread(int id) {
+        if (id == 0) {
+            PC_MODEL_WRITE(&payload);
+            payload = 42;
+            ready.store(true, std::memory_order_relaxed);
+        } else {
+            Backoff backoff;
+            while (!ready.load(std::memory_order_acquire)) {
+                backoff.pause();
+            }
+            PC_MODEL_READ(&payload);
+        }
+    }
+
+    void verify() {}
+};
+
+// Self-check: store buffering. With relaxed atomics both loads may return 0,
+// and the checker must find that outcome (reported as a failure here).
+struct StoreBuffering {
+    Atomic<int> x{0};
+    Atomic<int> y{0};
+    int seen[2] = {-1, -1};
+
+    void thread(int id) {
+        Atomic<int>& mine = id == 0 ? x : y;
+        Atomic<int>& other = id == 0 ? y : x;
+        mine.store(1, std::memory_order_relaxed);
+        seen[id] = other.load(std::memory_order_relaxed);
+    }
+
+    void verify() { model_assert(seen[0] == 1 || seen[1] == 1, "weak outcome: both threads read 0"); }
+};
+
+struct Scenario {
+    std::string name;
+    bool expect_failure;
+    std::function<ModelChecker::Result(const ModelChecker::Options&)> run;
+};
+
+// min_preemptions raises the bound for a scenario whose bug needs a deeper schedule
+template<typename S>
+Scenario scenario(const std::string& name, int threads, bool expect_failure = false, int min_preemptions = 0) {
+    return {name, expect_failure, [threads, min_preemptions](const ModelChecker::Options& options) {
+                ModelChecker::Options raised = options;
+                raised.max_preemptions = std::max(raised.max_preemptions, min_preemptions);
+                return ModelChecker::check<S>(threads, raised);
+            }};
+}
+
+int main(int argc, char* argv[]) {
+    ModelChecker::Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--preemptions") == 0 && i + 1 < argc) {
+            options.max_preemptions = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--stale-reads") == 0 && i + 1 < argc) {
+            options.max_stale_reads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--random") == 0 && i + 1 < argc) {
+            options.random_executions = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--preemptions N] [--stale-reads N] [--random N] [--seed S]\n";
+            return 2;
+        }
+    }
+
+    std::vector<Scenario> scenarios = {
+        scenario<RingBufferMpmc>("RingBuffer 2P/1C", 3),
+        scenario<OneProducerTwoConsumers<RingBuffer<int>>>("RingBuffer 1P/2C + shutdown", 3),
+        scenario<PushVersusShutdown<RingBuffer<int>>>("RingBuffer push vs shutdown", 3),
+        scenario<OneProducerTwoConsumers<SpmcRing<int>>>("SpmcRing 1P/2C + shutdown", 3),
+        scenario<PushVersusShutdown<SpmcRing<int>>>("SpmcRing push vs shutdown", 3),
+        scenario<SpscOneEach>("SpscRing 1P/1C + shutdown", 2),
+        scenario<MpscTwoProducers>("MpscQueue 2P/1C", 3),
+        scenario<PushVersusShutdown<MpscQueue<int>>>("MpscQueue push vs shutdown", 3),
+        scenario<BroadcastTwoStages>("BroadcastRing 2 stages", 3),
+        scenario<LeaseTwoConsumers>("LeaseBuffer 1P/2C + shutdown", 3),
+        scenario<LeaseExtendVersusSteal>("LeaseBuffer extend vs expired steal", 2, false, 3),
+        scenario<RelaxedPublication>("self-check: relaxed publication", 2, true),
+        scenario<StoreBuffering>("self-check: store buffering", 2, true),
+    };
+
+    std::cout << "\n=== QUEUE MODEL CHECK ===\n";
+    if (options.random_executions > 0) {
+        std::cout << "[MAIN] " << options.random_executions << " random schedules per scenario, seed "
+                  << options.seed << "\n";
+    } else {
+        std::cout << "[MAIN] Exhaustive, at most " << options.max_preemptions << " preemptions and "
+                  << options.max_stale_reads << " stale reads per execution\n";
+    }
+
+    bool passed = true;
+    for (const Scenario& entry : scenarios) {
+        auto start = std::chrono::steady_clock::now();
+        ModelChecker::Result result = entry.run(options);
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        std::string detail = std::to_string(result.executions) + " executions" +
+                             (result.exhaustive ? ", exhaustive" : "") + ", " + std::to_string(ms.count()) + " ms";
+        if (result.passed == entry.expect_failure) {
+            passed = false;
+            std::cout << "[FAIL] " << entry.name << " (" << detail << ")";
+            if (entry.expect_failure) {
+                std::cout << ": the checker missed a bug it must find\n";
+            } else {
+                std::cout << ": " << result.failure << "\n" << result.trace;
+            }
+        } else if (entry.expect_failure) {
+            std::cout << "[PASS] " << entry.name << " found: " << result.failure << " (" << detail << ")\n";
+        } else {
+            std::cout << "[PASS] " << entry.name << " (" << detail << ")\n";
+        }
+    }
+
+    if (!passed) {
+        std::cout << "=== QUEUE MODEL CHECK FAILED ===\n\n";
+        return 1;
+    }
+    std::cout << "=== QUEUE MODEL CHECK PASSED ===\n\n";
+    return 0;
+}
@@ -0,0 +1,208 @@
+#ifndef PRODUCER_CONSUMER_MPSC_QUEUE_H
+#define PRODUCER_CONSUMER_MPSC_QUEUE_H
+
+#include <cstddef>
+#include <utility>
+
+#include "atomics.h"
+#include "backoff.h"
+
+/**
+ * Lock-Free Intrusive MPSC Queue
+ *
+ * Many producers, exactly one consumer: the most common topology, and the
+ * one where Buffer's mutex and RingBuffer's CAS loops buy the least.
+ * This is Dmitry Vyukov's intrusive MPSC queue:
+ * - A producer links its node with one atomic exchange on the head and one
+ *   store into the previous node. No CAS, so no retry loop: push is
+ *   wait-free no matter how many producers there are
+ * - The consumer owns the tail and only reads what producers published, so
+ *   it never contends with them (and never with another consumer, since
+ *   there is none)
+ * - A permanent stub node keeps the list non-empty, so neither side ever
+ *   handles a null head
+ *
+ * The catch: between a producer's exchange and its store, the consumer
+ * cannot see past that node. try_pop() then reports "nothing yet" even
+ * though the queue is not empty; pop() simply waits for the store.
+ *
+ * IntrusiveMpscQueue links caller-owned nodes (anything deriving from
+ * MpscNode), so pushing allocates nothing. MpscQueue<T> wraps it with the
+ * usual push/pop/try_pop/shutdown API and allocates one node per item.
+ * Both are unbounded.
+ *
+ * MpscQueue keeps its shutdown flag and a count of pushes in flight in one
+ * word. A push registers itself in that word before linking its node, so
+ * it either sees the shutdown and fails, or pop() sees it in flight and
+ * waits for it: a push that returned true is always delivered. That costs
+ * two more wait-free RMWs per push.
+ */
+
+struct MpscNode {
+    Atomic<MpscNode*> next{nullptr};
+};
+
+class IntrusiveMpscQueue {
+private:
+    alignas(64) Atomic<MpscNode*> head_;        // Producers: last node pushed
+    alignas(64) MpscNode* tail_;                // Consumer: next node to hand out
+    MpscNode stub_;
+
+public:
+    IntrusiveMpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+    IntrusiveMpscQueue(const IntrusiveMpscQueue&) = delete;
+    IntrusiveMpscQueue& operator=(const IntrusiveMpscQueue&) = delete;
+
+    // Any thread. The node must stay alive until it has been popped.
+    void push(MpscNode* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        MpscNode* previous = head_.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);      // Publish
+    }
+
+    // Consumer only. Returns nullptr if nothing can be popped right now;
+    // `pending` is then set if a producer is halfway through a push.
+    MpscNode* pop(bool& pending) {
+        pending = false;
+        MpscNode* tail = tail_;
+        MpscNode* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (next == nullptr) {
+                pending = head_.load(std::memory_order_acquire) != &stub_;
+                return nullptr;
+            }
+            tail_ = next;                   // Skip the stub
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail_ = next;
+            return tail;
+        }
+
+        // tail looks like the last node. If it is not the head, a producer
+        // has exchanged the head but not yet linked its node.
+        if (tail != head_.load(std::memory_order_acquire)) {
+            pending = true;
+            return nullptr;
+        }
+        // Re-insert the stub behind tail so tail can be handed out
+        push(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail_ = next;
+            return tail;
+        }
+        pending = true;                     // Another push got in before the stub
+        return nullptr;
+    }
+
+    MpscNode* pop() {
+        bool pending;
+        return pop(pending);
+    }
+
+    // Consumer only: nothing pushed and not popped, not even half-pushed
+    bool empty() const {
+        return tail_->next.load(std::memory_order_acquire) == nullptr &&
+               head_.load(std::memory_order_acquire) == tail_;
+    }
+};
+
+template<typename T>
+class MpscQueue {
+private:
+    struct Node : MpscNode {
+        T item;
+
+        explicit Node(T value) : item(std::move(value)) {}
+    };
+
+    static constexpr size_t CLOSED = 1;     // Bit 0 of state_: shut down
+    static constexpr size_t PUSHING = 2;    // The rest: pushes in flight
+
+    IntrusiveMpscQueue queue_;
+    alignas(64) Atomic<size_t> state_{0};
+
+    bool take(T& item, bool& pending) {
+        MpscNode* node = queue_.pop(pending);
+        if (node == nullptr) {
+            return false;
+        }
+        Node* owned = static_cast<Node*>(node);
+        PC_MODEL_WRITE(&owned->item);
+        item = std::move(owned->item);
+        PC_MODEL_FREE(&owned->item);
+        delete owned;
+        return true;
+    }
+
+public:
+    MpscQueue() = default;
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    ~MpscQueue() {
+        T item;
+        bool pending;
+        while (take(item, pending)) {
+        }
+    }
+
+    // Any thread; never blocks. Returns false after shutdown().
+    bool push(T item) {
+        Node* node = new Node(std::move(item));
+        PC_MODEL_WRITE(&node->item);
+        // An RMW reads the latest state, so either the shutdown is seen here or pop() sees this push in flight
+        if (state_.fetch_add(PUSHING, std::memory_order_relaxed) & CLOSED) {
+            state_.fetch_sub(PUSHING, std::memory_order_relaxed);
+            PC_MODEL_FREE(&node->item);
+            delete node;
+            return false;
+        }
+        queue_.push(node);
+        state_.fetch_sub(PUSHING, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only
+    bool try_pop(T& item) {
+        bool pending;
+        return take(item, pending);
+    }
+
+    // Consumer only. Blocks until an item arrives; returns false once shut
+    // down and drained, including pushes that were still in flight.
+    bool pop(T& item) {
+        Backoff backoff;
+        for (;;) {
+            // Read the state first: every push that finished before it is then seen by take()
+            size_t state = state_.load(std::memory_order_acquire);
+            bool pending;
+            if (take(item, pending)) {
+                return true;
+            }
+            if (state == CLOSED) {
+                return false;               // Shut down, and no push was still in flight
+            }
+            backoff.pause();
+        }
+    }
+
+    void shutdown() {
+        size_t state = state_.load(std::memory_order_relaxed);
+        while (!(state & CLOSED) &&
+               !state_.compare_exchange_weak(state, state | CLOSED, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+        }
+    }
+
+    bool is_shutdown() const { return state_.load(std::memory_order_acquire) & CLOSED; }
+
+    // Consumer only
+    bool empty() const { return queue_.empty(); }
+};
+
+#endif // PRODUCER_CONSUMER_MPSC_QUEUE_H
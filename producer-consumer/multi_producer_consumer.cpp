@@ -1,105 +1,40 @@
 #include <iostream>
 #include <thread>
-#include <mutex>
-#include <condition_variable>
-#include <queue>
 #include <string>
 #include <chrono>
+#include <memory>
 #include <vector>
 #include <atomic>
 
+#include "channel.h"
+
 /**
  * Multi Producer-Consumer Synchronization Demo
  * 
  * This version demonstrates the changes needed when scaling from single
- * to multiple producers and consumers.
+ * to multiple producers and consumers. The queue is the mutex and two
+ * condition variable Buffer described in README.md (buffer.h), wrapped in
+ * Sender/Receiver handles (see channel.h).
  */
 
-class Buffer {
-private:
-    std::queue<std::string> data_;
-    mutable std::mutex mutex_;
-    std::condition_variable not_empty_;     // Separate condition for consumers
-    std::condition_variable not_full_;      // Separate condition for producers
-    static const size_t MAX_SIZE = 10;
-    std::atomic<bool> shutdown_{false};     // Explicit shutdown flag
+const size_t NUM_PRODUCERS = 3;
+const size_t NUM_CONSUMERS = 2;
+const size_t MAX_SIZE = 10;             // Channel capacity
 
-public:
-    void push(const std::string& item) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        
-        // Wait if buffer is full, but also check for shutdown
-        not_full_.wait(lock, [this] { 
-            return data_.size() < MAX_SIZE || shutdown_.load(); 
-        });
-        
-        // Don't add if we're shutting down
-        if (shutdown_.load()) {
-            return;
-        }
-        
-        data_.push(item);
-        std::cout << "[BUFFER] Added: '" << item << "' (Buffer size: " << data_.size() << ")\n";
-        
-        // Wake up one waiting consumer
-        not_empty_.notify_one();
-    }
-    
-    bool pop(std::string& item) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        
-        // Wait until data is available or shutdown
-        not_empty_.wait(lock, [this] { 
-            return !data_.empty() || shutdown_.load(); 
-        });
-        
-        // If shutdown and empty, return false
-        if (data_.empty() && shutdown_.load()) {
-            return false;
-        }
-        
-        if (!data_.empty()) {
-            item = data_.front();
-            data_.pop();
-            std::cout << "[BUFFER] Removed: '" << item << "' (Buffer size: " << data_.size() << ")\n";
-            
-            // Wake up one waiting producer
-            not_full_.notify_one();
-            return true;
-        }
-        return false;
-    }
-    
-    void shutdown() {
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            shutdown_.store(true);
-        }
-        // Wake up ALL waiting threads
-        not_empty_.notify_all();
-        not_full_.notify_all();
-    }
-    
-    size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return data_.size();
-    }
-    
-    bool empty() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return data_.empty();
-    }
-};
+// Blocked producers and consumers sleep on Buffer's condition variables
+// instead of spinning on a lock-free ring
+using MessageSender = Sender<std::string, Buffer<std::string>>;
+using MessageReceiver = Receiver<std::string, Buffer<std::string>>;
 
 class Producer {
 private:
-    Buffer& buffer_;
+    MessageSender sender_;
     std::atomic<bool>& running_;
     int id_;
     
 public:
-    Producer(Buffer& buffer, std::atomic<bool>& running, int id) 
-        : buffer_(buffer), running_(running), id_(id) {}
+    Producer(MessageSender sender, std::atomic<bool>& running, int id) 
+        : sender_(std::move(sender)), running_(running), id_(id) {}
     
     void produce() {
         std::cout << "[PRODUCER " << id_ << "] Starting production...\n";
@@ -109,25 +44,27 @@ public:
             std::string data = "P" + std::to_string(id_) + "_Msg_" + std::to_string(count++);
             
             std::cout << "[PRODUCER " << id_ << "] Producing: '" << data << "'\n";
-            buffer_.push(data);
+            sender_.send(data);
             
             // Different producers can have different speeds
             std::this_thread::sleep_for(std::chrono::milliseconds(300 + (id_ * 100)));
         }
         
         std::cout << "[PRODUCER " << id_ << "] Stopping. Total produced: " << count << "\n";
+        
+        // The last producer to stop closes the channel
+        sender_.close();
     }
 };
 
 class Consumer {
 private:
-    Buffer& buffer_;
-    std::atomic<bool>& running_;
+    MessageReceiver receiver_;
     int id_;
     
 public:
-    Consumer(Buffer& buffer, std::atomic<bool>& running, int id) 
-        : buffer_(buffer), running_(running), id_(id) {}
+    Consumer(MessageReceiver receiver, int id) 
+        : receiver_(std::move(receiver)), id_(id) {}
     
     void consume() {
         std::cout << "[CONSUMER " << id_ << "] Starting consumption...\n";
@@ -135,14 +72,9 @@ public:
         int count = 0;
         std::string data;
         
-        // Continue until explicitly told to stop AND buffer is empty
-        while (running_.load() || buffer_.pop(data)) {
-            if (running_.load() && !buffer_.pop(data)) {
-                // If running but couldn't get data, try again
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                continue;
-            }
-            
+        // recv() blocks until there is data and only returns false once every
+        // producer's sender is gone AND the channel is empty, so this drains everything
+        while (receiver_.recv(data)) {
             if (!data.empty()) {
                 std::cout << "[CONSUMER " << id_ << "] Processing: '" << data << "'\n";
                 
@@ -162,30 +94,31 @@ public:
 int main() {
     std::cout << "\n=== MULTI PRODUCER-CONSUMER DEMO ===\n";
     
-    Buffer shared_buffer;
+    auto [sender, receiver] = open_channel_over<std::string>([] { return Buffer<std::string>(MAX_SIZE); });
     std::atomic<bool> running{true};
-    
-    // Create multiple producers and consumers
-    const int NUM_PRODUCERS = 3;
-    const int NUM_CONSUMERS = 2;
+    std::cout << "[MAIN] Channel: Buffer (mutex + condition variables), capacity " << MAX_SIZE << "\n";
     
     std::vector<std::unique_ptr<Producer>> producers;
     std::vector<std::unique_ptr<Consumer>> consumers;
     std::vector<std::thread> producer_threads;
     std::vector<std::thread> consumer_threads;
     
-    // Create producers
-    for (int i = 1; i <= NUM_PRODUCERS; ++i) {
-        producers.emplace_back(std::make_unique<Producer>(shared_buffer, running, i));
+    // Create producers, each with its own clone of the sender
+    for (int i = 1; i <= static_cast<int>(NUM_PRODUCERS); ++i) {
+        producers.emplace_back(std::make_unique<Producer>(sender, running, i));
         producer_threads.emplace_back(&Producer::produce, producers.back().get());
     }
     
-    // Create consumers
-    for (int i = 1; i <= NUM_CONSUMERS; ++i) {
-        consumers.emplace_back(std::make_unique<Consumer>(shared_buffer, running, i));
+    // Create consumers, each with its own clone of the receiver
+    for (int i = 1; i <= static_cast<int>(NUM_CONSUMERS); ++i) {
+        consumers.emplace_back(std::make_unique<Consumer>(receiver, i));
         consumer_threads.emplace_back(&Consumer::consume, consumers.back().get());
     }
     
+    // main neither sends nor receives; only the clones keep the channel open
+    sender.close();
+    receiver.close();
+    
     std::cout << "Started " << NUM_PRODUCERS << " producers and " << NUM_CONSUMERS << " consumers\n";
     
     // Let system run
@@ -193,7 +126,6 @@ int main() {
     
     std::cout << "\n[MAIN] Initiating shutdown...\n";
     running.store(false);
-    shared_buffer.shutdown();
     
     // Join all threads
     std::cout << "[MAIN] Waiting for producers to finish...\n";
@@ -206,7 +138,6 @@ int main() {
         thread.join();
     }
     
-    std::cout << "\n[MAIN] Final buffer size: " << shared_buffer.size() << "\n";
     std::cout << "=== MULTI DEMO COMPLETED ===\n\n";
     
     return 0;
@@ -0,0 +1,52 @@
+#ifndef PRODUCER_CONSUMER_OVERFLOW_POLICY_H
+#define PRODUCER_CONSUMER_OVERFLOW_POLICY_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Overflow Policies
+ *
+ * What push() does when the buffer is full:
+ * - Block:      wait for space (the classic bounded buffer, default)
+ * - DropNewest: discard the item being pushed
+ * - DropOldest: discard the oldest queued item to make room (overwrite)
+ * - Sample:     under overflow keep only every Nth new item (overwriting the
+ *               oldest), drop the rest. Consumers still see fresh data, at
+ *               a reduced rate, without the queue being churned on every push
+ *
+ * The three lossy policies never block, so a slow consumer can never stall
+ * a producer. That suits telemetry streams, where freshness matters more
+ * than completeness.
+ */
+
+enum class OverflowPolicy {
+    Block,
+    DropNewest,
+    DropOldest,
+    Sample
+};
+
+inline const char* to_string(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::Block:      return "block";
+        case OverflowPolicy::DropNewest: return "drop-newest";
+        case OverflowPolicy::DropOldest: return "drop-oldest";
+        case OverflowPolicy::Sample:     return "sample";
+    }
+    return "unknown";
+}
+
+struct DropCounts {
+    uint64_t newest = 0;    // Items rejected by push()
+    uint64_t oldest = 0;    // Queued items overwritten to make room
+
+    uint64_t total() const { return newest + oldest; }
+};
+
+// Sample policy: the Nth, 2Nth, ... overflowing push is kept
+inline bool sample_keeps(uint64_t overflow_index, size_t sample_every) {
+    return sample_every <= 1 || overflow_index % sample_every == 0;
+}
+
+#endif // PRODUCER_CONSUMER_OVERFLOW_POLICY_H
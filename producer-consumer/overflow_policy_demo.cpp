@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "buffer.h"
+#include "ring_buffer.h"
+
+/**
+ * Overflow Policy Demo
+ *
+ * A telemetry producer emits sample numbers much faster than the consumer
+ * can process them. For every overflow policy, on both the mutex-based
+ * Buffer and the lock-free RingBuffer, the demo reports:
+ * - how long the producer took to emit everything (did it stall?)
+ * - how many samples the consumer saw and how many were dropped
+ * - the last sample the consumer saw (freshness)
+ */
+
+const uint64_t NUM_SAMPLES = 500;
+const size_t CAPACITY = 8;
+
+template<typename Queue>
+void run(const std::string& backend, OverflowPolicy policy) {
+    Queue queue(CAPACITY, policy);
+    uint64_t consumed = 0;
+    uint64_t last_seen = 0;
+
+    std::thread consumer([&] {
+        uint64_t sample;
+        while (queue.pop(sample)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));   // Slow consumer
+            consumed++;
+            last_seen = sample;
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t sample = 1; sample <= NUM_SAMPLES; ++sample) {
+        queue.push(sample);
+        std::this_thread::sleep_for(std::chrono::microseconds(50));     // Fast producer
+    }
+    auto producer_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    queue.shutdown();
+    consumer.join();
+
+    DropCounts dropped = queue.dropped();
+    std::string drops = std::to_string(dropped.newest) + "/" + std::to_string(dropped.oldest);
+    std::cout << std::left << std::setw(13) << backend << std::setw(13) << to_string(policy)
+              << "producer=" << std::setw(6) << (std::to_string(producer_ms) + "ms")
+              << " consumed=" << std::setw(5) << consumed << " dropped(new/old)=" << std::setw(8) << drops
+              << " last seen=" << last_seen << "\n";
+}
+
+int main() {
+    std::cout << "\n=== OVERFLOW POLICY DEMO ===\n";
+    std::cout << NUM_SAMPLES << " samples, capacity " << CAPACITY
+              << ", producer every 50us, consumer needs 1ms per sample\n\n";
+
+    for (OverflowPolicy policy : {OverflowPolicy::Block, OverflowPolicy::DropNewest,
+                                  OverflowPolicy::DropOldest, OverflowPolicy::Sample}) {
+        run<Buffer<uint64_t>>("[Buffer]", policy);
+        run<RingBuffer<uint64_t>>("[RingBuffer]", policy);
+    }
+
+    std::cout << "\n=== OVERFLOW POLICY DEMO COMPLETED ===\n\n";
+
+    return 0;
+}
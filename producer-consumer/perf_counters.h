@@ -0,0 +1,143 @@
+#ifndef PRODUCER_CONSUMER_PERF_COUNTERS_H
+#define PRODUCER_CONSUMER_PERF_COUNTERS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * Hardware Performance Counters (Linux perf_event_open)
+ *
+ * Throughput says which backend is faster; counters say why: more cycles per
+ * message, fewer instructions retired per cycle, cache lines bouncing
+ * between cores (cache/LLC misses), mispredicted spin loops (branch misses)
+ * or threads going to sleep (context switches).
+ *
+ *   PerfCounters counters;      // in the thread that will start the workers
+ *   counters.start();
+ *   ... start threads, run, join them ...
+ *   PerfCounters::Reading reading = counters.stop();
+ *
+ * Counters are opened with `inherit`, so threads created after the
+ * constructor are counted too; their counts are folded in when they exit,
+ * so read after joining them. Hardware events count user space only, which
+ * is what perf_event_paranoid <= 2 allows without privileges. When the kernel
+ * multiplexes counters, values are scaled by enabled/running time.
+ *
+ * Counters the machine does not offer (VMs often have no PMU; containers
+ * may forbid the syscall) are reported as unavailable rather than failing,
+ * so the same benchmark runs everywhere.
+ */
+class PerfCounters {
+public:
+    enum Event { CYCLES, INSTRUCTIONS, CACHE_MISSES, LLC_MISSES, BRANCH_MISSES, CONTEXT_SWITCHES, EVENT_COUNT };
+
+    struct Reading {
+        std::array<uint64_t, EVENT_COUNT> values{};
+        std::array<bool, EVENT_COUNT> valid{};
+    };
+
+    static const char* name(Event event) {
+        switch (event) {
+            case CYCLES:           return "cycles";
+            case INSTRUCTIONS:     return "instructions";
+            case CACHE_MISSES:     return "cache-misses";
+            case LLC_MISSES:       return "llc-misses";
+            case BRANCH_MISSES:    return "branch-misses";
+            case CONTEXT_SWITCHES: return "context-switches";
+            case EVENT_COUNT:      break;
+        }
+        return "unknown";
+    }
+
+private:
+    std::array<int, EVENT_COUNT> fds_;
+
+    static int open_event(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;                   // Count threads started later
+        // Software events (context switches) happen in the kernel by definition
+        attr.exclude_kernel = type == PERF_TYPE_SOFTWARE ? 0 : 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    void control(unsigned long request) {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, request, 0);
+            }
+        }
+    }
+
+public:
+    PerfCounters() {
+        const uint64_t llc_read_miss = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        fds_[CYCLES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds_[INSTRUCTIONS] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds_[CACHE_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds_[LLC_MISSES] = open_event(PERF_TYPE_HW_CACHE, llc_read_miss);
+        fds_[BRANCH_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds_[CONTEXT_SWITCHES] = open_event(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    bool available(Event event) const { return fds_[event] >= 0; }
+
+    bool any_available() const {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void start() {
+        control(PERF_EVENT_IOC_RESET);
+        control(PERF_EVENT_IOC_ENABLE);
+    }
+
+    Reading stop() {
+        control(PERF_EVENT_IOC_DISABLE);
+        Reading reading;
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+            uint64_t data[3];               // value, time enabled, time running
+            if (fds_[i] < 0 || read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+                continue;
+            }
+            if (data[2] == 0) {
+                continue;                   // Never got scheduled onto the PMU
+            }
+            double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+            reading.values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * scale);
+            reading.valid[i] = true;
+        }
+        return reading;
+    }
+};
+
+#endif // PRODUCER_CONSUMER_PERF_COUNTERS_H
@@ -0,0 +1,289 @@
+#ifndef PRODUCER_CONSUMER_PIPELINE_H
+#define PRODUCER_CONSUMER_PIPELINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "buffer.h"
+
+/**
+ * Multi-Stage Pipeline Builder
+ *
+ * Generalizes the single producer -> Buffer -> consumer setup to a chain of
+ * stages (e.g. parse -> enrich -> aggregate -> sink):
+ *
+ *   auto pipeline = make_pipeline<std::string>("read", read_line)
+ *       .stage("parse", 2, parse)       // new thread group, Buffer in front of it
+ *       .fuse(enrich)                   // runs inside the "parse" threads, no Buffer
+ *       .stage("aggregate", 1, aggregate)
+ *       .sink("sink", 1, print);
+ *   pipeline->start();
+ *   pipeline->wait();
+ *
+ * - stage() starts a new thread group with its own parallelism. The previous
+ *   group hands items over through a bounded Buffer.
+ * - fuse() appends a function to the current group. The two functions are
+ *   composed into one loop, so no lock, notify or cache transfer happens
+ *   between them.
+ * - Every Buffer is bounded, so a slow sink blocks the stage in front of it,
+ *   which blocks the stage in front of that, all the way back to the source
+ *   (end-to-end backpressure).
+ * - When the last thread of a group finishes, it shuts down the Buffer behind
+ *   it. Downstream threads drain what is left and then finish too.
+ *
+ * Stage functions of a group with parallelism > 1 are shared between its
+ * threads, so they must be thread-safe.
+ *
+ * Calling auto_fuse() right after make_pipeline() lets the builder decide:
+ * adjacent stages with the same parallelism are fused instead of being
+ * connected through a Buffer. See fusion.h for fusing at compile time.
+ */
+
+// Hands an item to the next stage. Returns false when the next stage is closed.
+template<typename T>
+using Emit = std::function<bool(T)>;
+
+class Pipeline {
+private:
+    struct StageGroup {
+        std::string name;
+        size_t parallelism;
+        std::function<void()> body;          // Loop run by each thread of the group
+        std::function<void()> on_finished;   // Called once by the last thread to finish
+        std::atomic<size_t> running{0};
+    };
+
+    std::vector<std::unique_ptr<StageGroup>> groups_;
+    std::vector<std::function<void()>> buffer_shutdowns_;
+    std::vector<std::string> buffer_descriptions_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stopped_{false};
+
+    template<typename Out>
+    friend class PipelineBuilder;
+
+    void add_group(std::string name, size_t parallelism, std::function<void()> body,
+                   std::function<void()> on_finished) {
+        auto group = std::make_unique<StageGroup>();
+        group->name = std::move(name);
+        group->parallelism = parallelism;
+        group->body = std::move(body);
+        group->on_finished = std::move(on_finished);
+        groups_.push_back(std::move(group));
+    }
+
+    template<typename T>
+    void add_buffer(const std::shared_ptr<Buffer<T>>& buffer) {
+        buffer_shutdowns_.emplace_back([buffer] { buffer->shutdown(); });
+        buffer_descriptions_.push_back("[Buffer " + std::to_string(buffer->capacity()) + "]");
+    }
+
+public:
+    Pipeline() = default;
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    ~Pipeline() {
+        if (!threads_.empty()) {
+            stop();
+            wait();
+        }
+    }
+
+    void start() {
+        for (auto& group : groups_) {
+            group->running.store(group->parallelism);
+            for (size_t i = 0; i < group->parallelism; ++i) {
+                StageGroup* g = group.get();
+                threads_.emplace_back([g] {
+                    g->body();
+                    if (g->running.fetch_sub(1) == 1 && g->on_finished) {
+                        g->on_finished();
+                    }
+                });
+            }
+        }
+    }
+
+    // Blocks until every stage has drained and finished
+    void wait() {
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        threads_.clear();
+    }
+
+    // Stops the source and shuts every Buffer down. Pushes fail from then on,
+    // but Buffer::pop() drains what is already queued, so downstream stages
+    // still process those items before they finish; wait() returns after that
+    void stop() {
+        stopped_.store(true);
+        for (auto& shutdown : buffer_shutdowns_) {
+            shutdown();
+        }
+    }
+
+    bool stopped() const { return stopped_.load(); }
+
+    size_t stage_count() const { return groups_.size(); }
+    size_t buffer_count() const { return buffer_shutdowns_.size(); }
+
+    // Prints the thread groups and the Buffers between them, e.g.
+    // read x1 -> [Buffer 10] -> parse+enrich x2 -> [Buffer 10] -> sink x1
+    void describe(std::ostream& os) const {
+        for (size_t i = 0; i < groups_.size(); ++i) {
+            os << groups_[i]->name << " x" << groups_[i]->parallelism;
+            if (i < buffer_descriptions_.size()) {
+                os << " -> " << buffer_descriptions_[i] << " -> ";
+            }
+        }
+        os << "\n";
+    }
+};
+
+template<typename Out>
+class PipelineBuilder {
+private:
+    // Given the downstream Emit, builds the loop run by each thread of the
+    // current (still open) group. Fusing wraps the Emit; a new stage
+    // finalizes the group with an Emit that pushes into a Buffer.
+    using WorkerFactory = std::function<std::function<void()>(Emit<Out>)>;
+
+    std::shared_ptr<Pipeline> pipeline_;
+    std::string name_;
+    size_t parallelism_;
+    size_t capacity_;
+    WorkerFactory make_worker_;
+    bool auto_fuse_ = false;
+
+    template<typename T>
+    friend class PipelineBuilder;
+
+    PipelineBuilder(std::shared_ptr<Pipeline> pipeline, std::string name, size_t parallelism,
+                    size_t capacity, WorkerFactory make_worker, bool auto_fuse = false)
+        : pipeline_(std::move(pipeline)), name_(std::move(name)), parallelism_(parallelism),
+          capacity_(capacity), make_worker_(std::move(make_worker)), auto_fuse_(auto_fuse) {}
+
+    // Closes the current group: its items go into a new Buffer that the
+    // returned function reads from
+    std::shared_ptr<Buffer<Out>> close_group() {
+        auto buffer = std::make_shared<Buffer<Out>>(capacity_);
+        pipeline_->add_buffer(buffer);
+        pipeline_->add_group(name_, parallelism_,
+                             make_worker_([buffer](Out item) { return buffer->push(std::move(item)); }),
+                             [buffer] { buffer->shutdown(); });
+        return buffer;
+    }
+
+public:
+    template<typename Source>
+    static PipelineBuilder from_source(std::string name, Source source, size_t capacity) {
+        auto pipeline = std::make_shared<Pipeline>();
+        const std::atomic<bool>* stopped = &pipeline->stopped_;
+        auto shared_source = std::make_shared<Source>(std::move(source));
+
+        WorkerFactory make_worker = [shared_source, stopped](Emit<Out> emit) {
+            return std::function<void()>([shared_source, stopped, emit] {
+                Out item;
+                while (!stopped->load() && (*shared_source)(item)) {
+                    if (!emit(std::move(item))) {
+                        break;
+                    }
+                }
+            });
+        };
+        return PipelineBuilder(std::move(pipeline), std::move(name), 1, capacity, std::move(make_worker));
+    }
+
+    // From here on, stage() and sink() fuse into the current group instead of
+    // adding a Buffer whenever their parallelism matches the current group's
+    PipelineBuilder auto_fuse() && {
+        auto_fuse_ = true;
+        return std::move(*this);
+    }
+
+    // Starts a new thread group fed through a bounded Buffer. Throws
+    // std::invalid_argument if parallelism is 0: a group without threads
+    // would never drain its input, and stop() would hang.
+    template<typename F, typename R = std::invoke_result_t<F&, Out>>
+    PipelineBuilder<R> stage(std::string name, size_t parallelism, F fn) {
+        if (parallelism < 1) {
+            throw std::invalid_argument("pipeline stage '" + name + "' needs a parallelism of at least 1");
+        }
+        if (auto_fuse_ && parallelism == parallelism_) {
+            return fuse(std::move(name), std::move(fn));
+        }
+
+        auto input = close_group();
+        auto shared_fn = std::make_shared<F>(std::move(fn));
+
+        typename PipelineBuilder<R>::WorkerFactory make_worker = [input, shared_fn](Emit<R> emit) {
+            return std::function<void()>([input, shared_fn, emit] {
+                Out item;
+                while (input->pop(item)) {
+                    if (!emit((*shared_fn)(std::move(item)))) {
+                        // Downstream is closed: stop reading and unblock our producers
+                        input->shutdown();
+                        break;
+                    }
+                }
+            });
+        };
+        return PipelineBuilder<R>(pipeline_, std::move(name), parallelism, capacity_,
+                                  std::move(make_worker), auto_fuse_);
+    }
+
+    // Appends fn to the current group; it runs on the same threads with no Buffer
+    template<typename F, typename R = std::invoke_result_t<F&, Out>>
+    PipelineBuilder<R> fuse(F fn) {
+        auto shared_fn = std::make_shared<F>(std::move(fn));
+        WorkerFactory make_prev = std::move(make_worker_);
+
+        typename PipelineBuilder<R>::WorkerFactory make_worker = [make_prev, shared_fn](Emit<R> emit) {
+            return make_prev([shared_fn, emit](Out item) { return emit((*shared_fn)(std::move(item))); });
+        };
+        return PipelineBuilder<R>(pipeline_, name_ + "+fused", parallelism_, capacity_,
+                                  std::move(make_worker), auto_fuse_);
+    }
+
+    // Same as fuse(), but with a name for describe()
+    template<typename F, typename R = std::invoke_result_t<F&, Out>>
+    PipelineBuilder<R> fuse(std::string name, F fn) {
+        auto next = fuse(std::move(fn));
+        next.name_ = name_ + "+" + name;
+        return next;
+    }
+
+    // Terminates the pipeline with a consuming function
+    template<typename F>
+    std::shared_ptr<Pipeline> sink(std::string name, size_t parallelism, F fn) {
+        static_assert(std::is_invocable_v<F&, Out>, "sink function must accept the stage output");
+        auto last = stage(std::move(name), parallelism, [fn = std::move(fn)](Out item) mutable {
+            fn(std::move(item));
+            return true;
+        });
+        last.pipeline_->add_group(last.name_, last.parallelism_,
+                                  last.make_worker_([](bool) { return true; }), nullptr);
+        return last.pipeline_;
+    }
+};
+
+// Starts a pipeline with a single-threaded source. The source fills `item`
+// and returns true, or returns false when it has nothing more to produce.
+template<typename Out, typename Source>
+PipelineBuilder<Out> make_pipeline(std::string name, Source source, size_t capacity = 10) {
+    return PipelineBuilder<Out>::from_source(std::move(name), std::move(source), capacity);
+}
+
+#endif // PRODUCER_CONSUMER_PIPELINE_H
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "pipeline.h"
+
+/**
+ * Multi-Stage Pipeline Demo
+ *
+ * parse -> enrich -> aggregate -> sink, built from stage functions instead of
+ * hand-written Producer/Consumer classes. "parse" and "enrich" are fused into
+ * the same two threads, so only two Buffers exist for four processing steps.
+ */
+
+struct Reading {
+    std::string sensor;
+    int value = 0;
+    std::string label;
+};
+
+struct Summary {
+    std::string sensor;
+    int count = 0;
+    int total = 0;
+};
+
+std::mutex cout_mutex;
+
+int main() {
+    std::cout << "\n=== MULTI-STAGE PIPELINE DEMO ===\n";
+
+    const int NUM_MESSAGES = 20;
+    int next = 0;
+
+    // Source: produces raw "sensor,value" lines
+    auto read_line = [&next](std::string& line) {
+        if (next >= NUM_MESSAGES) {
+            return false;
+        }
+        line = "sensor_" + std::to_string(next % 3) + "," + std::to_string(next * 10);
+        ++next;
+        return true;
+    };
+
+    auto parse = [](std::string line) {
+        Reading reading;
+        auto comma = line.find(',');
+        reading.sensor = line.substr(0, comma);
+        reading.value = std::stoi(line.substr(comma + 1));
+        return reading;
+    };
+
+    auto enrich = [](Reading reading) {
+        reading.label = reading.value >= 100 ? "HIGH" : "low";
+        return reading;
+    };
+
+    // Single-threaded stage, so its state needs no lock
+    std::map<std::string, Summary> totals;
+    auto aggregate = [&totals](Reading reading) {
+        Summary& summary = totals[reading.sensor];
+        summary.sensor = reading.sensor;
+        summary.count++;
+        summary.total += reading.value;
+        return summary;
+    };
+
+    auto print = [](Summary summary) {
+        // Slow sink: the Buffers in front of it fill up and throttle the source
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::lock_guard<std::mutex> lock(cout_mutex);
+        std::cout << "[SINK] " << summary.sensor << ": count=" << summary.count
+                  << " total=" << summary.total << "\n";
+    };
+
+    auto pipeline = make_pipeline<std::string>("read", read_line, 4)
+        .stage("parse", 2, parse)
+        .fuse("enrich", enrich)
+        .stage("aggregate", 1, aggregate)
+        .sink("sink", 1, print);
+
+    std::cout << "[MAIN] Topology: ";
+    pipeline->describe(std::cout);
+    std::cout << "[MAIN] " << pipeline->stage_count() << " thread groups, "
+              << pipeline->buffer_count() << " buffers\n\n";
+
+    pipeline->start();
+    pipeline->wait();
+
+    std::cout << "\n[MAIN] Pipeline drained\n";
+    for (const auto& [sensor, summary] : totals) {
+        std::cout << "[MAIN] " << sensor << " -> " << summary.count << " readings, total "
+                  << summary.total << "\n";
+    }
+    std::cout << "=== PIPELINE DEMO COMPLETED ===\n\n";
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+#ifndef PRODUCER_CONSUMER_RING_BUFFER_H
+#define PRODUCER_CONSUMER_RING_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "atomics.h"
+#include "backoff.h"
+#include "overflow_policy.h"
+
+/**
+ * Lock-Free Bounded MPMC Ring Buffer
+ *
+ * A lock-free alternative to Buffer<T> with the same push/pop/try_pop/
+ * shutdown API, based on Dmitry Vyukov's bounded MPMC queue:
+ * - Every slot carries a sequence number telling whether it is ready to be
+ *   written (seq == pos) or read (seq == pos + 1)
+ * - Producers and consumers claim positions with a CAS on their own cursor,
+ *   so they never touch a mutex and never contend with each other unless
+ *   the ring is full or empty
+ *
+ * Overflow policies (see overflow_policy.h) are implemented on top of the
+ * lock-free try_push/try_pop, so the lossy ones never take a lock and never
+ * block. Blocking calls spin, then yield (see backoff.h).
+ *
+ * shutdown() sets a flag bit in the producers' cursor, so it is ordered
+ * against every claim: a push either claimed its slot before the shutdown
+ * (and pop() waits for it to be published) or fails. A push that returned
+ * true is therefore always delivered.
+ *
+ * Capacity is rounded up to a power of two.
+ */
+template<typename T>
+class RingBuffer {
+private:
+    struct Slot {
+        Atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t round_up_pow2(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // Top bit of enqueue_pos_: set by shutdown(), fails every later claim
+    static constexpr size_t CLOSED = ~(~size_t(0) >> 1);
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    const OverflowPolicy policy_;
+    const size_t sample_every_;
+
+    // Producers and consumers each get their own cache line
+    alignas(64) Atomic<size_t> enqueue_pos_{0};      // Position | CLOSED after shutdown
+    alignas(64) Atomic<size_t> dequeue_pos_{0};
+    Atomic<uint64_t> dropped_newest_{0};
+    Atomic<uint64_t> dropped_oldest_{0};
+    Atomic<uint64_t> overflows_{0};
+
+    // Moves from item only on success, so push() can retry with it
+    bool try_push_from(T& item) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (pos & CLOSED) {
+                return false;
+            }
+            Slot& slot = slots_[pos & mask_];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    PC_MODEL_WRITE(&slot.data);
+                    slot.data = std::move(item);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;       // Slot still holds an unread item: full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Make room by discarding the oldest item (if a consumer was faster, fine)
+    void evict_oldest() {
+        T discarded;
+        if (try_pop(discarded)) {
+            dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    explicit RingBuffer(size_t capacity = 16, OverflowPolicy policy = OverflowPolicy::Block,
+                        size_t sample_every = 4)
+        : capacity_(round_up_pow2(capacity < 2 ? 2 : capacity)), mask_(capacity_ - 1),
+          slots_(new Slot[capacity_]), policy_(policy), sample_every_(sample_every) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // Never blocks; returns false if the ring is full or shut down
+    bool try_push(T item) {
+        return try_push_from(item);
+    }
+
+    bool try_pop(T& item) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    PC_MODEL_WRITE(&slot.data);     // Moving out writes too
+                    item = std::move(slot.data);
+                    // Hand the slot back to producers for the next lap
+                    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;       // Slot not written yet: empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Applies the overflow policy when full. Returns true if the item was queued.
+    bool push(T item) {
+        Backoff backoff;
+        int sampled = -1;                   // Sample: keep/drop, decided once per push
+        while (!(enqueue_pos_.load(std::memory_order_relaxed) & CLOSED)) {
+            if (try_push_from(item)) {
+                return true;
+            }
+
+            switch (policy_) {
+                case OverflowPolicy::Block:
+                    backoff.pause();
+                    break;
+                case OverflowPolicy::DropNewest:
+                    dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                case OverflowPolicy::DropOldest:
+                    evict_oldest();
+                    break;
+                case OverflowPolicy::Sample:
+                    // A retry after evicting may find the ring full again; that is
+                    // still the same overflow, so count it only the first time
+                    if (sampled < 0) {
+                        sampled = sample_keeps(overflows_.fetch_add(1, std::memory_order_relaxed) + 1, sample_every_);
+                    }
+                    if (!sampled) {
+                        dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    evict_oldest();
+                    break;
+            }
+        }
+        return false;
+    }
+
+    // Blocks until an item is available or the ring is shut down and drained
+    bool pop(T& item) {
+        Backoff backoff;
+        for (;;) {
+            if (try_pop(item)) {
+                return true;
+            }
+            size_t end = enqueue_pos_.load(std::memory_order_acquire);
+            if ((end & CLOSED) && dequeue_pos_.load(std::memory_order_relaxed) == (end & ~CLOSED)) {
+                // No slot can be claimed any more, and every claimed one has been popped
+                return false;
+            }
+            // Empty, or a producer claimed a slot before shutdown and is still writing it
+            backoff.pause();
+        }
+    }
+
+    void shutdown() {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (!(pos & CLOSED) &&
+               !enqueue_pos_.compare_exchange_weak(pos, pos | CLOSED, std::memory_order_release,
+                                                   std::memory_order_relaxed)) {
+        }
+    }
+
+    bool is_shutdown() const { return enqueue_pos_.load(std::memory_order_acquire) & CLOSED; }
+
+    DropCounts dropped() const {
+        DropCounts counts;
+        counts.newest = dropped_newest_.load(std::memory_order_relaxed);
+        counts.oldest = dropped_oldest_.load(std::memory_order_relaxed);
+        return counts;
+    }
+
+    OverflowPolicy policy() const { return policy_; }
+    size_t capacity() const { return capacity_; }
+
+    // Approximate while other threads are active
+    size_t size() const {
+        size_t tail = dequeue_pos_.load(std::memory_order_acquire);
+        size_t head = enqueue_pos_.load(std::memory_order_acquire) & ~CLOSED;
+        return head > tail ? head - tail : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+};
+
+#endif // PRODUCER_CONSUMER_RING_BUFFER_H
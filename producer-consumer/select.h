@@ -0,0 +1,180 @@
+#ifndef PRODUCER_CONSUMER_SELECT_H
+#define PRODUCER_CONSUMER_SELECT_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "buffer.h"
+#include "select_waiter.h"
+#include "trace.h"
+
+/**
+ * Select (Multi-Buffer Receive)
+ *
+ * A consumer that serves several input Buffers would otherwise need a
+ * thread per buffer, or a loop of try_pop() calls and sleeps. Select waits
+ * on all of them at once, like Go's select:
+ *
+ *   Select select;
+ *   select.recv(orders, [](Order& order) { ... });        // case 0
+ *   select.recv(cancels, [](Cancel& cancel) { ... });     // case 1
+ *   for (;;) {
+ *       int fired = select.wait_for(std::chrono::milliseconds(100));
+ *       if (fired == Select::CLOSED) break;               // all shut down and drained
+ *       if (fired == Select::NONE_READY) { ... }          // timeout case
+ *   }
+ *
+ * Each call takes one item from one ready buffer, runs that case's handler
+ * on the calling thread and returns the case index. try_select() is the
+ * default case: it never blocks and returns NONE_READY if nothing is ready.
+ *
+ * - One waiter: the Select owns a single SelectWaiter, registered on every
+ *   buffer when the case is added. A push or shutdown on any of them wakes
+ *   it; nothing polls.
+ * - Fairness: each call starts scanning at the case after the one served
+ *   last, so ready cases are served round-robin and a busy buffer cannot
+ *   starve a quiet one.
+ * - Closing: a buffer that is shut down and drained drops out of the
+ *   select; once all have, calls return CLOSED.
+ *
+ * A Select belongs to one consumer thread. Other consumers may pop from the
+ * same buffers (they just compete for items), and the buffers must outlive
+ * the Select.
+ */
+class Select {
+private:
+    class Case {
+    public:
+        virtual ~Case() = default;
+        virtual bool try_take() = 0;        // Runs the handler on success
+        virtual bool drained() const = 0;
+        virtual void detach(SelectWaiter* waiter) = 0;
+    };
+
+    template<typename T, typename Handler>
+    class RecvCase : public Case {
+    private:
+        Buffer<T>& buffer_;
+        Handler handler_;
+
+    public:
+        RecvCase(Buffer<T>& buffer, Handler handler) : buffer_(buffer), handler_(std::move(handler)) {}
+
+        bool try_take() override {
+            T item;
+            if (!buffer_.try_pop(item)) {
+                return false;
+            }
+            handler_(item);
+            return true;
+        }
+
+        // Nothing is pushed after shutdown, so shut down AND empty is final
+        bool drained() const override { return buffer_.is_shutdown() && buffer_.empty(); }
+
+        void detach(SelectWaiter* waiter) override { buffer_.remove_waiter(waiter); }
+    };
+
+    std::vector<std::unique_ptr<Case>> cases_;
+    std::vector<bool> closed_;
+    size_t next_ = 0;                       // Where the next scan starts
+    SelectWaiter waiter_;
+
+    // One scan over the open cases, starting at next_
+    int poll() {
+        const size_t count = cases_.size();
+        for (size_t k = 0; k < count; ++k) {
+            size_t index = (next_ + k) % count;
+            if (!closed_[index] && cases_[index]->try_take()) {
+                next_ = (index + 1) % count;
+                return static_cast<int>(index);
+            }
+        }
+
+        bool open = false;
+        for (size_t index = 0; index < count; ++index) {
+            if (closed_[index]) {
+                continue;
+            }
+            if (cases_[index]->drained()) {
+                closed_[index] = true;
+                cases_[index]->detach(&waiter_);
+            } else {
+                open = true;
+            }
+        }
+        return open ? NONE_READY : CLOSED;
+    }
+
+    // park() returns false when it gives up (timeout)
+    template<typename Park>
+    int run(Park park) {
+        for (;;) {
+            // Reset before scanning: a push after the scan leaves the waiter signaled
+            waiter_.reset();
+            int fired = poll();
+            if (fired != NONE_READY) {
+                return fired;
+            }
+            PC_TRACE_SCOPE("wait select");
+            if (!park()) {
+                return poll();
+            }
+        }
+    }
+
+public:
+    static constexpr int NONE_READY = -1;   // try_select() found nothing, or the wait timed out
+    static constexpr int CLOSED = -2;       // Every buffer is shut down and drained
+
+    Select() = default;
+
+    Select(const Select&) = delete;
+    Select& operator=(const Select&) = delete;
+
+    ~Select() {
+        for (size_t index = 0; index < cases_.size(); ++index) {
+            if (!closed_[index]) {
+                cases_[index]->detach(&waiter_);
+            }
+        }
+    }
+
+    // Adds a case; handler(T&) runs on each item taken from buffer.
+    // Returns the index wait() reports for it.
+    template<typename T, typename Handler>
+    int recv(Buffer<T>& buffer, Handler handler) {
+        cases_.push_back(std::make_unique<RecvCase<T, Handler>>(buffer, std::move(handler)));
+        closed_.push_back(false);
+        buffer.add_waiter(&waiter_);
+        return static_cast<int>(cases_.size() - 1);
+    }
+
+    // Blocks until a case fires or every buffer is closed
+    int wait() {
+        return run([this] {
+            waiter_.wait();
+            return true;
+        });
+    }
+
+    template<typename Clock, typename Duration>
+    int wait_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+        return run([this, &deadline] { return waiter_.wait_until(deadline); });
+    }
+
+    template<typename Rep, typename Period>
+    int wait_for(const std::chrono::duration<Rep, Period>& timeout) {
+        return wait_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    // The default case: never blocks
+    int try_select() { return poll(); }
+
+    size_t size() const { return cases_.size(); }
+};
+
+#endif // PRODUCER_CONSUMER_SELECT_H
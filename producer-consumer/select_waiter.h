@@ -0,0 +1,55 @@
+#ifndef PRODUCER_CONSUMER_SELECT_WAITER_H
+#define PRODUCER_CONSUMER_SELECT_WAITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+/**
+ * Select Waiter
+ *
+ * The one place a Select (see select.h) parks. It is registered on every
+ * Buffer the Select watches, and each of them calls notify() after a push
+ * and on shutdown. The flag makes the wake-up sticky: the Select reset()s
+ * it before scanning its buffers, so a push that lands between the scan and
+ * wait() is not lost.
+ */
+class SelectWaiter {
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    bool signaled_ = false;                 // Protected by mutex_
+
+public:
+    SelectWaiter() = default;
+
+    SelectWaiter(const SelectWaiter&) = delete;
+    SelectWaiter& operator=(const SelectWaiter&) = delete;
+
+    void notify() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            signaled_ = true;
+        }
+        ready_.notify_one();
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        signaled_ = false;
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return signaled_; });
+    }
+
+    // Returns false if the deadline passed without a notify()
+    template<typename Clock, typename Duration>
+    bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return ready_.wait_until(lock, deadline, [this] { return signaled_; });
+    }
+};
+
+#endif // PRODUCER_CONSUMER_SELECT_WAITER_H
@@ -0,0 +1,357 @@
+#ifndef PRODUCER_CONSUMER_SHM_BUFFER_H
+#define PRODUCER_CONSUMER_SHM_BUFFER_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * Shared-Memory Inter-Process Buffer
+ *
+ * Buffer<T> only works between threads of one process. SharedMemoryBuffer<T>
+ * keeps the same push/pop/try_pop/shutdown API, but lives in a POSIX
+ * shared-memory segment so producers and consumers can be separate
+ * processes:
+ *
+ *   auto buffer = SharedMemoryBuffer<Message>::create("/orders", 1024);  // owner
+ *   auto buffer = SharedMemoryBuffer<Message>::open("/orders");          // peers
+ *
+ * - The segment only contains offsets and counters, never raw pointers, so
+ *   it is valid wherever each process happens to map it
+ * - The mutex is PTHREAD_PROCESS_SHARED and robust: if a peer dies while
+ *   holding it, the next locker gets EOWNERDEAD and simply marks it
+ *   consistent again. Every update writes the slot first and publishes it
+ *   with a single release store of the counter, so a crash can never leave
+ *   a half-written item visible
+ * - Waiting uses futexes on two event counters instead of pthread condition
+ *   variables. A process-shared pthread_cond_t keeps per-waiter bookkeeping,
+ *   and a waiter killed inside pthread_cond_wait() can block every later
+ *   signal. A futex word holds no such state, so a dead waiter costs at most
+ *   one wasted wakeup
+ * - T is copied byte-wise, so it must be trivially copyable (no std::string;
+ *   use fixed-size char arrays)
+ *
+ * Errors from the OS are reported as std::system_error.
+ */
+template<typename T>
+class SharedMemoryBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SharedMemoryBuffer<T> copies items byte-wise between processes");
+
+private:
+    static const uint32_t MAGIC = 0x53484d42;   // "SHMB"
+    static const uint32_t VERSION = 1;
+
+    // Everything in here must be position independent
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t capacity;
+        uint64_t item_size;
+        uint64_t slots_offset;              // From the start of the segment
+        pthread_mutex_t mutex;
+        uint32_t not_empty_events;          // Futex words, bumped on every push/pop
+        uint32_t not_full_events;
+        uint32_t empty_waiters;             // Protected by mutex
+        uint32_t full_waiters;
+        uint64_t head;                      // Total items popped; see publish()
+        uint64_t tail;                      // Total items pushed; see publish()
+        uint32_t shutdown;
+        uint64_t owner_deaths;              // Times a peer died holding the mutex
+    };
+
+    void* base_ = nullptr;
+    size_t mapped_size_ = 0;
+    std::string name_;
+
+    static size_t slots_offset() {
+        return (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    static size_t segment_size(size_t capacity) {
+        return slots_offset() + capacity * sizeof(T);
+    }
+
+    static void check(int result, const char* what) {
+        if (result != 0) {
+            throw std::system_error(result, std::generic_category(), what);
+        }
+    }
+
+    static void check_errno(bool ok, const char* what) {
+        if (!ok) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+    }
+
+    Header* header() const { return static_cast<Header*>(base_); }
+
+    // head/tail are what make a slot visible. The mutex alone does not help
+    // against a peer that dies mid-update: the compiler could otherwise
+    // advance the counter before the slot copy is complete. So they are
+    // stored with release after the copy and loaded with acquire before it.
+    static void publish(uint64_t* index, uint64_t value) { __atomic_store_n(index, value, __ATOMIC_RELEASE); }
+
+    static uint64_t observe(const uint64_t* index) { return __atomic_load_n(index, __ATOMIC_ACQUIRE); }
+
+    T* slot(uint64_t position) const {
+        char* slots = static_cast<char*>(base_) + header()->slots_offset;
+        return reinterpret_cast<T*>(slots) + position % header()->capacity;
+    }
+
+    SharedMemoryBuffer(void* base, size_t mapped_size, std::string name)
+        : base_(base), mapped_size_(mapped_size), name_(std::move(name)) {}
+
+    static void* map(int fd, size_t size) {
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        check_errno(base != MAP_FAILED, "mmap");
+        return base;
+    }
+
+    // Recovers the mutex if its previous owner died while holding it
+    void lock() {
+        int result = pthread_mutex_lock(&header()->mutex);
+        if (result == EOWNERDEAD) {
+            recover();
+        } else {
+            check(result, "pthread_mutex_lock");
+        }
+    }
+
+    void unlock() { pthread_mutex_unlock(&header()->mutex); }
+
+    // Called with the mutex held; the syscall is skipped when nobody waits
+    void notify(uint32_t* events, uint32_t waiters, int count) {
+        __atomic_add_fetch(events, 1, __ATOMIC_RELEASE);
+        if (waiters > 0) {
+            syscall(SYS_futex, events, FUTEX_WAKE, count, nullptr, nullptr, 0);
+        }
+    }
+
+    void recover() {
+        // head/tail are only ever advanced after the slot is complete, so
+        // the ring itself is consistent; only the mutex needs repairing
+        header()->owner_deaths++;
+        pthread_mutex_consistent(&header()->mutex);
+    }
+
+    // RAII guard for the robust mutex. owned_ is only set once lock() has
+    // succeeded, so a lock() that throws while re-acquiring after a wait
+    // does not leave the destructor unlocking a mutex it does not hold.
+    class Lock {
+    private:
+        SharedMemoryBuffer& buffer_;
+        bool owned_ = false;
+
+    public:
+        explicit Lock(SharedMemoryBuffer& buffer) : buffer_(buffer) { lock(); }
+        ~Lock() {
+            if (owned_) {
+                unlock();
+            }
+        }
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        void lock() {
+            buffer_.lock();
+            owned_ = true;
+        }
+
+        void unlock() {
+            owned_ = false;
+            buffer_.unlock();
+        }
+    };
+
+    // Called with the mutex held through `lock`, returns with it held.
+    // Reading the event counter before unlocking means a notify() between
+    // unlock and FUTEX_WAIT changes the word, so the kernel returns
+    // immediately.
+    void wait(Lock& lock, uint32_t* events, uint32_t* waiters) {
+        uint32_t observed = __atomic_load_n(events, __ATOMIC_ACQUIRE);
+        (*waiters)++;
+        lock.unlock();
+        syscall(SYS_futex, events, FUTEX_WAIT, observed, nullptr, nullptr, 0);
+        lock.lock();
+        (*waiters)--;
+    }
+
+public:
+    // Creates the segment and initializes it. Fails with EEXIST if the name
+    // is taken, since truncating it would pull the memory out from under any
+    // live peer; unlink() a stale segment from a crashed run first. The
+    // creator should eventually call unlink(). Capacity must be at least 1.
+    static SharedMemoryBuffer create(const std::string& name, size_t capacity) {
+        if (capacity == 0) {
+            throw std::system_error(EINVAL, std::generic_category(), "shared memory buffer capacity 0");
+        }
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        check_errno(fd >= 0, "shm_open");
+        size_t size = segment_size(capacity);
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "ftruncate");
+        }
+        void* base = map(fd, size);
+        close(fd);
+
+        Header* h = static_cast<Header*>(base);
+        std::memset(h, 0, sizeof(Header));
+        h->capacity = capacity;
+        h->item_size = sizeof(T);
+        h->slots_offset = slots_offset();
+
+        pthread_mutexattr_t mutex_attr;
+        pthread_mutexattr_init(&mutex_attr);
+        pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST);
+        check(pthread_mutex_init(&h->mutex, &mutex_attr), "pthread_mutex_init");
+        pthread_mutexattr_destroy(&mutex_attr);
+
+        // Written last: open() refuses segments that are not initialized yet
+        __atomic_store_n(&h->version, VERSION, __ATOMIC_RELEASE);
+        __atomic_store_n(&h->magic, MAGIC, __ATOMIC_RELEASE);
+
+        return SharedMemoryBuffer(base, size, name);
+    }
+
+    // Attaches to a segment created by another process
+    static SharedMemoryBuffer open(const std::string& name) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        check_errno(fd >= 0, "shm_open");
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+            close(fd);
+            throw std::system_error(EINVAL, std::generic_category(), "shared memory segment too small");
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        void* base = map(fd, size);
+        close(fd);
+
+        Header* h = static_cast<Header*>(base);
+        if (__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != MAGIC || h->version != VERSION ||
+            h->item_size != sizeof(T) || h->capacity == 0 || segment_size(h->capacity) > size) {
+            munmap(base, size);
+            throw std::system_error(EINVAL, std::generic_category(), "incompatible shared memory segment");
+        }
+        return SharedMemoryBuffer(base, size, name);
+    }
+
+    static void unlink(const std::string& name) { shm_unlink(name.c_str()); }
+
+    SharedMemoryBuffer(SharedMemoryBuffer&& other) noexcept
+        : base_(std::exchange(other.base_, nullptr)), mapped_size_(other.mapped_size_),
+          name_(std::move(other.name_)) {}
+
+    SharedMemoryBuffer& operator=(SharedMemoryBuffer&& other) noexcept {
+        if (this != &other) {
+            if (base_) {
+                munmap(base_, mapped_size_);
+            }
+            base_ = std::exchange(other.base_, nullptr);
+            mapped_size_ = other.mapped_size_;
+            name_ = std::move(other.name_);
+        }
+        return *this;
+    }
+
+    SharedMemoryBuffer(const SharedMemoryBuffer&) = delete;
+    SharedMemoryBuffer& operator=(const SharedMemoryBuffer&) = delete;
+
+    // Unmaps this process's view; the segment stays until unlink()
+    ~SharedMemoryBuffer() {
+        if (base_) {
+            munmap(base_, mapped_size_);
+        }
+    }
+
+    bool push(const T& item) {
+        Lock lock(*this);
+        Header* h = header();
+        while (h->tail - observe(&h->head) >= h->capacity && !h->shutdown) {
+            wait(lock, &h->not_full_events, &h->full_waiters);
+        }
+        if (h->shutdown) {
+            return false;
+        }
+
+        uint64_t tail = h->tail;
+        std::memcpy(static_cast<void*>(slot(tail)), &item, sizeof(T));
+        publish(&h->tail, tail + 1);
+        notify(&h->not_empty_events, h->empty_waiters, 1);
+        return true;
+    }
+
+    bool pop(T& item) {
+        Lock lock(*this);
+        Header* h = header();
+        while (observe(&h->tail) == h->head && !h->shutdown) {
+            wait(lock, &h->not_empty_events, &h->empty_waiters);
+        }
+        if (observe(&h->tail) == h->head) {
+            return false;                   // Shut down and drained
+        }
+
+        uint64_t head = h->head;
+        std::memcpy(static_cast<void*>(&item), slot(head), sizeof(T));
+        publish(&h->head, head + 1);
+        notify(&h->not_full_events, h->full_waiters, 1);
+        return true;
+    }
+
+    bool try_pop(T& item) {
+        Lock lock(*this);
+        Header* h = header();
+        if (observe(&h->tail) == h->head) {
+            return false;
+        }
+
+        uint64_t head = h->head;
+        std::memcpy(static_cast<void*>(&item), slot(head), sizeof(T));
+        publish(&h->head, head + 1);
+        notify(&h->not_full_events, h->full_waiters, 1);
+        return true;
+    }
+
+    // Visible to every attached process
+    void shutdown() {
+        Lock lock(*this);
+        Header* h = header();
+        h->shutdown = 1;
+        notify(&h->not_empty_events, h->empty_waiters, INT32_MAX);
+        notify(&h->not_full_events, h->full_waiters, INT32_MAX);
+    }
+
+    size_t capacity() const { return header()->capacity; }
+
+    size_t size() {
+        Lock lock(*this);
+        return observe(&header()->tail) - observe(&header()->head);
+    }
+
+    bool empty() { return size() == 0; }
+
+    uint64_t owner_deaths() {
+        Lock lock(*this);
+        return header()->owner_deaths;
+    }
+
+    const std::string& name() const { return name_; }
+};
+
+#endif // PRODUCER_CONSUMER_SHM_BUFFER_H
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "shm_buffer.h"
+
+/**
+ * Shared-Memory Inter-Process Buffer Demo
+ *
+ * The parent process creates the segment and consumes. Two child processes
+ * attach to it by name and produce:
+ * - Producer 1 sends NUM_MESSAGES messages and exits normally
+ * - Producer 2 pushes as fast as it can until the parent SIGKILLs it, to
+ *   show that a crashed peer (even one killed while holding the mutex)
+ *   does not wedge the buffer
+ * Each message carries its send time, so the consumer reports the
+ * cross-process latency.
+ */
+
+struct Message {
+    int32_t producer;
+    uint64_t sequence;
+    int64_t sent_ns;
+    char text[32];
+};
+
+const char* SEGMENT_NAME = "/producer_consumer_shm_demo";
+const uint64_t NUM_MESSAGES = 100000;
+
+int64_t now_ns() {
+    // CLOCK_MONOTONIC is shared by all processes on the machine
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void run_producer(int id, uint64_t count) {
+    auto buffer = SharedMemoryBuffer<Message>::open(SEGMENT_NAME);
+    for (uint64_t seq = 0; seq < count; ++seq) {
+        Message message{};
+        message.producer = id;
+        message.sequence = seq;
+        std::snprintf(message.text, sizeof(message.text), "P%d_Msg_%llu", id,
+                      static_cast<unsigned long long>(seq));
+        message.sent_ns = now_ns();
+        if (!buffer.push(message)) {
+            break;
+        }
+    }
+}
+
+int main() {
+    std::cout << "\n=== SHARED-MEMORY IPC BUFFER DEMO ===\n";
+
+    SharedMemoryBuffer<Message>::unlink(SEGMENT_NAME);     // Leftover from an earlier crash
+    auto buffer = SharedMemoryBuffer<Message>::create(SEGMENT_NAME, 256);
+
+    // Fork before starting any threads in this process, and flush first so
+    // the children do not inherit (and print again) buffered output
+    std::cout.flush();
+    pid_t producer1 = fork();
+    if (producer1 == 0) {
+        run_producer(1, NUM_MESSAGES);
+        _exit(0);
+    }
+    pid_t producer2 = fork();
+    if (producer2 == 0) {
+        run_producer(2, UINT64_MAX);
+        _exit(0);
+    }
+    std::cout << "[MAIN] Producer 1 pid " << producer1 << ", producer 2 pid " << producer2 << "\n";
+
+    uint64_t received[3] = {0, 0, 0};
+    int64_t total_latency_ns = 0;
+    std::thread consumer([&] {
+        Message message;
+        while (buffer.pop(message)) {
+            total_latency_ns += now_ns() - message.sent_ns;
+            received[message.producer]++;
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::cout << "[MAIN] Killing producer 2 with SIGKILL\n";
+    kill(producer2, SIGKILL);
+    waitpid(producer2, nullptr, 0);
+
+    waitpid(producer1, nullptr, 0);
+    std::cout << "[MAIN] Producer 1 finished\n";
+
+    buffer.shutdown();
+    consumer.join();
+
+    uint64_t total = received[1] + received[2];
+    std::cout << "\n[MAIN] Received " << received[1] << "/" << NUM_MESSAGES << " from producer 1, "
+              << received[2] << " from producer 2 before it was killed\n";
+    std::cout << "[MAIN] Average push-to-pop latency (mostly queueing, the buffer stays full): " << (total ? total_latency_ns / static_cast<int64_t>(total) : 0)
+              << " ns\n";
+    std::cout << "[MAIN] Mutex recoveries after a dead owner: " << buffer.owner_deaths() << "\n";
+
+    SharedMemoryBuffer<Message>::unlink(SEGMENT_NAME);
+    std::cout << "=== SHARED-MEMORY DEMO COMPLETED ===\n\n";
+
+    return 0;
+}
@@ -1,97 +1,38 @@
 #include <iostream>
 #include <thread>
-#include <mutex>
-#include <condition_variable>
-#include <queue>
 #include <string>
 #include <chrono>
-#include <vector>
 #include <atomic>
 
+#include "channel.h"
+
 /**
  * Single Producer-Consumer Synchronization Demo
  * 
  * This program demonstrates thread-safe communication between a producer and consumer
- * using mutex, condition variables, and atomic operations. See README.md for detailed
+ * using mutex, condition variables, and atomic operations. The queue between them is
+ * Buffer (buffer.h), wrapped in Sender/Receiver handles (see channel.h). The producer
+ * holds the only Sender, so the channel closes itself when the producer is done, and
+ * the consumer drains it without watching any flag. See README.md for detailed
  * explanation of the synchronization problem and solution.
  */
 
-class Buffer {
-private:
-    std::queue<std::string> data_;           // Shared buffer (queue of strings)
-    mutable std::mutex mutex_;               // Mutex for protecting the buffer
-    std::condition_variable condition_;      // Condition variable for signaling
-    static const size_t MAX_SIZE = 10;       // Maximum buffer size to prevent unbounded growth
+const size_t MAX_SIZE = 10;             // Channel capacity, bounds memory use
 
-public:
-    // Producer calls this method to add data to the buffer
-    void push(const std::string& item) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        
-        // Wait if buffer is full (bounded buffer implementation)
-        condition_.wait(lock, [this] { return data_.size() < MAX_SIZE; });
-        
-        data_.push(item);
-        std::cout << "[BUFFER] Added: '" << item << "' (Buffer size: " << data_.size() << ")\n";
-        
-        // For multiple consumers: notify_one() is sufficient as only one consumer 
-        // needs to wake up to process the new item
-        condition_.notify_one();
-    }
-    
-    // Consumer calls this method to get data from the buffer
-    bool pop(std::string& item) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        
-        // Wait until data is available
-        condition_.wait(lock, [this] { return !data_.empty(); });
-        
-        if (!data_.empty()) {
-            item = data_.front();
-            data_.pop();
-            std::cout << "[BUFFER] Removed: '" << item << "' (Buffer size: " << data_.size() << ")\n";
-            
-            // For multiple producers: notify_one() is sufficient as only one producer
-            // needs to wake up when space becomes available
-            condition_.notify_one();
-            return true;
-        }
-        return false;
-    }
-    
-    // Non-blocking version for consumer to check if data is available
-    bool try_pop(std::string& item) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (!data_.empty()) {
-            item = data_.front();
-            data_.pop();
-            std::cout << "[BUFFER] Removed (try): '" << item << "' (Buffer size: " << data_.size() << ")\n";
-            condition_.notify_one();
-            return true;
-        }
-        return false;
-    }
-    
-    size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return data_.size();
-    }
-    
-    bool empty() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return data_.empty();
-    }
-};
+// Both threads spend most of their time waiting, so they sleep on Buffer's
+// condition variables rather than spin on a lock-free ring
+using MessageSender = Sender<std::string, Buffer<std::string>>;
+using MessageReceiver = Receiver<std::string, Buffer<std::string>>;
 
 class Producer {
 private:
-    Buffer& buffer_;
+    MessageSender sender_;
     std::atomic<bool>& running_;
     int id_;
     
 public:
-    Producer(Buffer& buffer, std::atomic<bool>& running, int id = 1) 
-        : buffer_(buffer), running_(running), id_(id) {}
+    Producer(MessageSender sender, std::atomic<bool>& running, int id = 1) 
+        : sender_(std::move(sender)), running_(running), id_(id) {}
     
     // This method runs in its own thread
     void produce() {
@@ -104,45 +45,46 @@ public:
             
             std::cout << "[PRODUCER " << id_ << "] Producing: '" << data << "'\n";
             
-            // Add data to buffer (this is the critical section that needs synchronization)
-            buffer_.push(data);
+            // Send data through the channel (this is the hand-off that needs synchronization)
+            sender_.send(data);
             
             // Simulate production time
             std::this_thread::sleep_for(std::chrono::milliseconds(500));
         }
         
         std::cout << "[PRODUCER " << id_ << "] Stopping production. Total produced: " << count << "\n";
+        
+        // Last sender gone: the channel closes and the consumer drains it
+        sender_.close();
     }
 };
 
 class Consumer {
 private:
-    Buffer& buffer_;
-    std::atomic<bool>& running_;
+    MessageReceiver receiver_;
     int id_;
     
 public:
-    Consumer(Buffer& buffer, std::atomic<bool>& running, int id = 1) 
-        : buffer_(buffer), running_(running), id_(id) {}
+    Consumer(MessageReceiver receiver, int id = 1) 
+        : receiver_(std::move(receiver)), id_(id) {}
     
     // This method runs in its own thread
     void consume() {
         std::cout << "[CONSUMER " << id_ << "] Starting consumption...\n";
         
         int count = 0;
-        while (running_.load() || !buffer_.empty()) {
-            std::string data;
+        std::string data;
+        
+        // recv() blocks until there is data and only returns false once the
+        // last sender is gone AND the channel is empty, so this drains everything
+        while (receiver_.recv(data)) {
+            std::cout << "[CONSUMER " << id_ << "] Consuming: '" << data << "'\n";
+            
+            // Simulate processing time
+            std::this_thread::sleep_for(std::chrono::milliseconds(700));
             
-            // Try to get data from buffer (this is the critical section that needs synchronization)
-            if (buffer_.pop(data)) {
-                std::cout << "[CONSUMER " << id_ << "] Consuming: '" << data << "'\n";
-                
-                // Simulate processing time
-                std::this_thread::sleep_for(std::chrono::milliseconds(700));
-                
-                std::cout << "[CONSUMER " << id_ << "] Processed: '" << data << "'\n";
-                count++;
-            }
+            std::cout << "[CONSUMER " << id_ << "] Processed: '" << data << "'\n";
+            count++;
         }
         
         std::cout << "[CONSUMER " << id_ << "] Stopping consumption. Total consumed: " << count << "\n";
@@ -152,15 +94,16 @@ public:
 int main() {
     std::cout << "=== SINGLE PRODUCER-CONSUMER SYNCHRONIZATION DEMO ===\n\n";
     
-    // Shared buffer that both producer and consumer will access
-    Buffer shared_buffer;
+    // One channel, split into the producer's end and the consumer's end
+    auto [sender, receiver] = open_channel_over<std::string>([] { return Buffer<std::string>(MAX_SIZE); });
+    std::cout << "[MAIN] Channel: Buffer (mutex + condition variables), capacity " << MAX_SIZE << "\n";
     
-    // Atomic flag to control when threads should stop
+    // Atomic flag to tell the producer when to stop; the consumer never looks at it
     std::atomic<bool> running{true};
     
-    // Create producer and consumer objects
-    Producer producer(shared_buffer, running);
-    Consumer consumer(shared_buffer, running);
+    // Create producer and consumer objects; each takes over its end of the channel
+    Producer producer(std::move(sender), running);
+    Consumer consumer(std::move(receiver));
     
     std::cout << "Starting producer and consumer threads...\n\n";
     
@@ -176,14 +119,13 @@ int main() {
     std::cout << "\n[MAIN] Signaling threads to stop...\n";
     running.store(false);
     
-    // Wait for threads to finish
+    // Wait for threads to finish; the consumer stops on its own once the channel is closed and drained
     std::cout << "[MAIN] Waiting for producer to finish...\n";
     producer_thread.join();
     
     std::cout << "[MAIN] Waiting for consumer to finish...\n";
     consumer_thread.join();
     
-    std::cout << "\n[MAIN] Final buffer size: " << shared_buffer.size() << "\n";
     std::cout << "=== DEMO COMPLETED ===\n";
     
     return 0;
@@ -0,0 +1,283 @@
+#ifndef PRODUCER_CONSUMER_SPILL_BUFFER_H
+#define PRODUCER_CONSUMER_SPILL_BUFFER_H
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "codec.h"
+
+/**
+ * Spill-to-Disk Buffer
+ *
+ * A bounded Buffer either blocks producers or, if unbounded, grows without
+ * limit when consumers fall behind. SpillBuffer<T> adds an overflow tier:
+ * - Up to `watermark` items are kept in memory
+ * - Beyond that, items are appended to a memory-mapped on-disk journal made
+ *   of fixed-size segment files (spill_<pid>_<instance>_000001.journal, ...).
+ *   The prefix keeps SpillBuffers that share a directory, in one process or
+ *   several, out of each other's files. Disk space is reserved when a segment
+ *   is created, so a full disk is reported from push() instead of crashing
+ *   the process with SIGBUS on a write to the mapping
+ * - pop() transparently reads journaled items back, in order
+ * - A segment is unlinked as soon as it has been fully read, so disk usage
+ *   follows the backlog, and both writes and reads are purely sequential
+ *
+ * Order is preserved: once anything has been spilled, new items also go to
+ * the journal until the consumers have caught up with it.
+ *
+ * Items are serialized with ItemCodec<T> (see codec.h).
+ */
+
+// Append-only journal of length-prefixed records in rotating mmap'd segments.
+// Not thread-safe on its own; SpillBuffer serializes access.
+class SpillJournal {
+private:
+    struct Segment {
+        std::string path;
+        char* data = nullptr;
+        size_t write_offset = 0;
+        size_t read_offset = 0;
+        bool sealed = false;                // No more writes; delete once read
+    };
+
+    using Length = uint32_t;
+
+    std::filesystem::path directory_;
+    std::string prefix_;                    // Unique per journal, see open_segment()
+    size_t segment_size_;
+    std::deque<Segment> segments_;          // Front is read, back is written
+    uint64_t next_segment_id_ = 1;
+    uint64_t records_ = 0;
+    uint64_t segments_created_ = 0;
+
+    static void fail(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static std::string unique_prefix() {
+        static std::atomic<uint64_t> instances{0};
+        return "spill_" + std::to_string(getpid()) + "_" + std::to_string(instances.fetch_add(1)) + "_";
+    }
+
+    void open_segment() {
+        char number[32];
+        std::snprintf(number, sizeof(number), "%06llu.journal", static_cast<unsigned long long>(next_segment_id_++));
+        Segment segment;
+        segment.path = (directory_ / (prefix_ + number)).string();
+
+        // O_EXCL: a leftover file with the same name (a crashed run whose pid
+        // was reused) is an error, never silently overwritten
+        int fd = ::open(segment.path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            fail("open " + segment.path);
+        }
+        // A sparse file would only run out of space on a write to the mapping (SIGBUS)
+        int error = posix_fallocate(fd, 0, static_cast<off_t>(segment_size_));
+        if (error != 0) {
+            ::close(fd);
+            ::unlink(segment.path.c_str());
+            errno = error;
+            fail("posix_fallocate " + segment.path);
+        }
+        void* data = mmap(nullptr, segment_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            error = errno;
+            ::unlink(segment.path.c_str());
+            errno = error;
+            fail("mmap " + segment.path);
+        }
+        madvise(data, segment_size_, MADV_SEQUENTIAL);
+
+        segment.data = static_cast<char*>(data);
+        segments_.push_back(std::move(segment));
+        segments_created_++;
+    }
+
+    void close_segment(Segment& segment) {
+        munmap(segment.data, segment_size_);
+        ::unlink(segment.path.c_str());
+    }
+
+public:
+    SpillJournal(std::filesystem::path directory, size_t segment_size)
+        : directory_(std::move(directory)), prefix_(unique_prefix()), segment_size_(segment_size) {
+        std::filesystem::create_directories(directory_);
+    }
+
+    SpillJournal(const SpillJournal&) = delete;
+    SpillJournal& operator=(const SpillJournal&) = delete;
+
+    // The journal only absorbs bursts; nothing survives the process
+    ~SpillJournal() {
+        for (auto& segment : segments_) {
+            close_segment(segment);
+        }
+    }
+
+    // encode(out) must write exactly `size` bytes
+    template<typename Encode>
+    void append(size_t size, Encode encode) {
+        size_t record_size = sizeof(Length) + size;
+        if (record_size > segment_size_) {
+            throw std::length_error("record larger than a journal segment");
+        }
+        if (segments_.empty() || segments_.back().sealed ||
+            segments_.back().write_offset + record_size > segment_size_) {
+            if (!segments_.empty()) {
+                segments_.back().sealed = true;
+            }
+            open_segment();
+        }
+
+        Segment& segment = segments_.back();
+        Length length = static_cast<Length>(size);
+        std::memcpy(segment.data + segment.write_offset, &length, sizeof(Length));
+        encode(segment.data + segment.write_offset + sizeof(Length));
+        segment.write_offset += record_size;
+        records_++;
+    }
+
+    // decode(data, size) reads the oldest record. Returns false if empty.
+    template<typename Decode>
+    bool read(Decode decode) {
+        while (!segments_.empty()) {
+            Segment& segment = segments_.front();
+            if (segment.read_offset < segment.write_offset) {
+                Length length;
+                std::memcpy(&length, segment.data + segment.read_offset, sizeof(Length));
+                decode(segment.data + segment.read_offset + sizeof(Length), static_cast<size_t>(length));
+                segment.read_offset += sizeof(Length) + length;
+                records_--;
+                return true;
+            }
+            if (!segment.sealed) {
+                return false;               // Caught up with the writer
+            }
+            close_segment(segment);
+            segments_.pop_front();
+        }
+        return false;
+    }
+
+    uint64_t records() const { return records_; }
+    size_t segments() const { return segments_.size(); }
+    uint64_t segments_created() const { return segments_created_; }
+};
+
+template<typename T, typename Codec = ItemCodec<T>>
+class SpillBuffer {
+private:
+    std::deque<T> memory_;
+    SpillJournal journal_;
+    const size_t watermark_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    bool shutdown_ = false;
+    uint64_t spilled_ = 0;
+
+    bool has_items() const { return !memory_.empty() || journal_.records() > 0; }
+
+public:
+    SpillBuffer(size_t watermark, std::filesystem::path directory, size_t segment_size = 16 << 20)
+        : journal_(std::move(directory), segment_size), watermark_(watermark) {}
+
+    SpillBuffer(const SpillBuffer&) = delete;
+    SpillBuffer& operator=(const SpillBuffer&) = delete;
+
+    // Never blocks: past the watermark, items go to disk instead
+    bool push(T item) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (shutdown_) {
+                return false;
+            }
+
+            if (journal_.records() == 0 && memory_.size() < watermark_) {
+                memory_.push_back(std::move(item));
+            } else {
+                journal_.append(Codec::size(item), [&item](char* out) { Codec::encode(item, out); });
+                spilled_++;
+            }
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return has_items() || shutdown_; });
+
+        if (!memory_.empty()) {
+            item = std::move(memory_.front());
+            memory_.pop_front();
+            return true;
+        }
+        // Memory tier is drained; everything older than the journal is gone
+        return journal_.read([&item](const char* data, size_t size) { Codec::decode(data, size, item); });
+    }
+
+    bool try_pop(T& item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!memory_.empty()) {
+            item = std::move(memory_.front());
+            memory_.pop_front();
+            return true;
+        }
+        return journal_.read([&item](const char* data, size_t size) { Codec::decode(data, size, item); });
+    }
+
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        not_empty_.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return memory_.size() + journal_.records();
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t in_memory() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return memory_.size();
+    }
+
+    uint64_t on_disk() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return journal_.records();
+    }
+
+    // Total items that went through the journal
+    uint64_t spilled() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return spilled_;
+    }
+
+    uint64_t segments_created() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return journal_.segments_created();
+    }
+};
+
+#endif // PRODUCER_CONSUMER_SPILL_BUFFER_H
@@ -0,0 +1,173 @@
+#ifndef PRODUCER_CONSUMER_SPMC_RING_H
+#define PRODUCER_CONSUMER_SPMC_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "atomics.h"
+#include "backoff.h"
+
+/**
+ * Lock-Free SPMC Ring (One Producer, Many Consumers)
+ *
+ * For 1:N dispatch, Buffer makes the producer take the same mutex as every
+ * consumer, and RingBuffer makes it CAS a cursor that nobody else writes.
+ * SpmcRing drops both for the producer:
+ * - Every slot carries a sequence number, as in RingBuffer: seq == pos
+ *   means free for the write at pos, seq == pos + 1 means readable
+ * - The producer owns the write position. It checks that the slot is free,
+ *   claims it with a CAS on its own cursor, moves the item in with plain
+ *   stores and publishes it with one release store of the slot sequence.
+ *   The CAS only ever races shutdown(), so its cost does not depend on how
+ *   many consumers there are
+ * - Consumers claim a position with one CAS on the shared read cursor and
+ *   hand the slot back for the next lap with a release store
+ *
+ * shutdown() sets a flag bit in the write cursor, which fails the claim:
+ * a push either claimed its slot before the shutdown (and pop() waits for
+ * it to be published) or fails. A push that returned true is therefore
+ * always delivered.
+ *
+ * push()/try_push() must only be called from one thread at a time.
+ * Capacity is rounded up to a power of two. Blocking calls spin, then yield
+ * (see backoff.h).
+ */
+template<typename T>
+class SpmcRing {
+private:
+    struct alignas(64) Slot {
+        Atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t round_up_pow2(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // Top bit of write_pos_: set by shutdown(), fails every later claim
+    static constexpr size_t CLOSED = ~(~size_t(0) >> 1);
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(64) Atomic<size_t> write_pos_{0};          // The producer and shutdown() CAS here
+    alignas(64) Atomic<size_t> read_pos_{0};           // Consumers CAS here
+
+    // Moves from item only on success, so push() can retry with it
+    bool try_push_from(T& item) {
+        size_t pos = write_pos_.load(std::memory_order_relaxed);
+        if (pos & CLOSED) {
+            return false;
+        }
+        Slot& slot = slots_[pos & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != pos) {
+            return false;                   // A consumer has not finished with the previous lap
+        }
+        // Only shutdown() can have changed the cursor since the load
+        if (!write_pos_.compare_exchange_strong(pos, pos + 1, std::memory_order_relaxed)) {
+            return false;
+        }
+        PC_MODEL_WRITE(&slot.data);
+        slot.data = std::move(item);
+        slot.sequence.store(pos + 1, std::memory_order_release);    // Publish
+        return true;
+    }
+
+public:
+    explicit SpmcRing(size_t capacity = 1024)
+        : capacity_(round_up_pow2(capacity < 2 ? 2 : capacity)), mask_(capacity_ - 1),
+          slots_(new Slot[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    SpmcRing(const SpmcRing&) = delete;
+    SpmcRing& operator=(const SpmcRing&) = delete;
+
+    // Producer only. Never blocks; returns false if the ring is full or shut down.
+    bool try_push(T item) {
+        return try_push_from(item);
+    }
+
+    // Producer only. Blocks while the ring is full; false after shutdown().
+    bool push(T item) {
+        Backoff backoff;
+        while (!(write_pos_.load(std::memory_order_relaxed) & CLOSED)) {
+            if (try_push_from(item)) {
+                return true;
+            }
+            backoff.pause();
+        }
+        return false;
+    }
+
+    bool try_pop(T& item) {
+        size_t pos = read_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (read_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    PC_MODEL_WRITE(&slot.data);     // Moving out writes too
+                    item = std::move(slot.data);
+                    // Hand the slot back to the producer for the next lap
+                    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;               // Not published yet: empty
+            } else {
+                pos = read_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Blocks until an item is available or the ring is shut down and drained
+    bool pop(T& item) {
+        Backoff backoff;
+        for (;;) {
+            if (try_pop(item)) {
+                return true;
+            }
+            size_t end = write_pos_.load(std::memory_order_acquire);
+            if ((end & CLOSED) && read_pos_.load(std::memory_order_relaxed) == (end & ~CLOSED)) {
+                // No slot can be claimed any more, and every claimed one has been popped
+                return false;
+            }
+            // Empty, or the producer claimed a slot before shutdown and is still writing it
+            backoff.pause();
+        }
+    }
+
+    void shutdown() {
+        size_t pos = write_pos_.load(std::memory_order_relaxed);
+        while (!(pos & CLOSED) &&
+               !write_pos_.compare_exchange_weak(pos, pos | CLOSED, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+        }
+    }
+
+    bool is_shutdown() const { return write_pos_.load(std::memory_order_acquire) & CLOSED; }
+
+    size_t capacity() const { return capacity_; }
+
+    // Approximate while both sides are running
+    size_t size() const {
+        size_t write = write_pos_.load(std::memory_order_relaxed) & ~CLOSED;
+        size_t read = read_pos_.load(std::memory_order_relaxed);
+        return write > read ? write - read : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+};
+
+#endif // PRODUCER_CONSUMER_SPMC_RING_H
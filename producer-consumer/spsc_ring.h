@@ -0,0 +1,138 @@
+#ifndef PRODUCER_CONSUMER_SPSC_RING_H
+#define PRODUCER_CONSUMER_SPSC_RING_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "atomics.h"
+#include "backoff.h"
+
+/**
+ * Lock-Free SPSC Ring (One Producer, One Consumer)
+ *
+ * With exactly one thread on each side nobody ever competes for a
+ * position, so this is the cheapest queue in the project (Lamport's ring):
+ * - The producer owns the tail, the consumer owns the head. Each side
+ *   publishes its index with a release store; no CAS, no exchange, no
+ *   per-slot sequence numbers
+ * - Each side keeps a private copy of the other side's index and only
+ *   re-reads the shared one when the copy says full (producer) or empty
+ *   (consumer), so in steady state the two cache lines are not bounced
+ *   back and forth on every item
+ *
+ * push()/try_push() must only be called from one thread at a time, and so
+ * must pop()/try_pop(). Capacity is rounded up to a power of two. Blocking
+ * calls spin, then yield (see backoff.h).
+ */
+template<typename T>
+class SpscRing {
+private:
+    static size_t round_up_pow2(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    alignas(64) Atomic<size_t> head_{0};   // Next position to read; only the consumer stores here
+    size_t cached_tail_ = 0;                // Consumer-local: last tail_ seen
+    alignas(64) Atomic<size_t> tail_{0};   // Next position to write; only the producer stores here
+    size_t cached_head_ = 0;                // Producer-local: last head_ seen
+    alignas(64) Atomic<bool> shutdown_{false};
+
+    // Moves from item only on success, so push() can retry with it
+    bool try_push_from(T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == capacity_) {
+                return false;               // The consumer has not freed a slot yet
+            }
+        }
+        T& slot = slots_[tail & mask_];
+        PC_MODEL_WRITE(&slot);
+        slot = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);          // Publish
+        return true;
+    }
+
+public:
+    explicit SpscRing(size_t capacity = 1024)
+        : capacity_(round_up_pow2(capacity < 2 ? 2 : capacity)), mask_(capacity_ - 1),
+          slots_(new T[capacity_]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer only. Never blocks; returns false if the ring is full.
+    bool try_push(T item) {
+        return try_push_from(item);
+    }
+
+    // Producer only. Blocks while the ring is full; false after shutdown().
+    bool push(T item) {
+        Backoff backoff;
+        while (!shutdown_.load(std::memory_order_relaxed)) {
+            if (try_push_from(item)) {
+                return true;
+            }
+            backoff.pause();
+        }
+        return false;
+    }
+
+    // Consumer only
+    bool try_pop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;               // Nothing published yet: empty
+            }
+        }
+        T& slot = slots_[head & mask_];
+        PC_MODEL_WRITE(&slot);              // Moving out writes too
+        item = std::move(slot);
+        head_.store(head + 1, std::memory_order_release);          // Hand the slot back
+        return true;
+    }
+
+    // Consumer only. Blocks until an item is available or the ring is shut
+    // down and drained.
+    bool pop(T& item) {
+        Backoff backoff;
+        for (;;) {
+            if (try_pop(item)) {
+                return true;
+            }
+            if (shutdown_.load(std::memory_order_acquire)) {
+                // A push may have completed just before shutdown
+                return try_pop(item);
+            }
+            backoff.pause();
+        }
+    }
+
+    void shutdown() { shutdown_.store(true, std::memory_order_release); }
+
+    bool is_shutdown() const { return shutdown_.load(std::memory_order_acquire); }
+
+    size_t capacity() const { return capacity_; }
+
+    // Approximate while both sides are running
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+};
+
+#endif // PRODUCER_CONSUMER_SPSC_RING_H
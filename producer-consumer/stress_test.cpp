@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "buffer.h"
+#include "delay_buffer.h"
+#include "durable_buffer.h"
+#include "lease_buffer.h"
+#include "mpsc_queue.h"
+#include "ring_buffer.h"
+#include "select.h"
+#include "spill_buffer.h"
+#include "spmc_ring.h"
+#include "spsc_ring.h"
+#ifdef __linux__
+#include "shm_buffer.h"
+#endif
+
+/**
+ * Buffer Stress Test
+ *
+ * Runs randomized N:M workloads against every queue with Buffer semantics
+ * (one consumer gets each item) and checks the results:
+ * - Exactly once: every pushed item is popped once; nothing is lost or
+ *   duplicated
+ * - Per-producer FIFO, per consumer: no consumer sees a producer's item
+ *   after a later item of the same producer
+ * - Per-producer FIFO, in real time: no pop of a later item finishes before
+ *   a pop of an earlier item (same producer) starts. This is what a
+ *   linearizable FIFO queue guarantees across consumers
+ * - Causality: no item is popped before its push started
+ *
+ * Capacities are kept tiny so that the full/empty paths, wraparound and
+ * blocking are hit constantly. LeaseBuffer only promises approximate FIFO,
+ * so only exactly-once and causality are checked there. "Select" spreads
+ * the producers over two Buffers and has every consumer pop through a
+ * Select over both. A last check destroys a DelayBuffer whose ready
+ * Buffer is full with nobody consuming, which must not hang.
+ *
+ *   buffer-stress-test [--rounds N] [--seed S]
+ *
+ * Exits with 1 on the first failing round. Registered with ctest, both as
+ * a normal build and, where available, a ThreadSanitizer build.
+ */
+
+struct Item {
+    uint32_t producer = 0;
+    uint32_t sequence = 0;
+    int64_t pushed_at = 0;                  // steady_clock ns when push() started
+};
+
+// What every queue under test is adapted to
+class StressTarget {
+public:
+    virtual ~StressTarget() = default;
+    virtual bool push(const Item& item) = 0;
+    virtual bool pop(Item& item) = 0;
+    virtual void shutdown() = 0;
+};
+
+template<typename Queue>
+class PlainTarget : public StressTarget {
+private:
+    std::unique_ptr<Queue> queue_;
+
+public:
+    explicit PlainTarget(std::unique_ptr<Queue> queue) : queue_(std::move(queue)) {}
+
+    bool push(const Item& item) override { return queue_->push(item); }
+    bool pop(Item& item) override { return queue_->pop(item); }
+    void shutdown() override { queue_->shutdown(); }
+};
+
+class LeaseTarget : public StressTarget {
+private:
+    LeaseBuffer<Item> buffer_;
+
+public:
+    // Long lease: a slow (sanitized) consumer must not trigger redelivery
+    explicit LeaseTarget(size_t capacity) : buffer_(capacity, std::chrono::seconds(30)) {}
+
+    bool push(const Item& item) override { return buffer_.push(item); }
+
+    bool pop(Item& item) override {
+        LeaseBuffer<Item>::Lease lease;
+        if (!buffer_.pop(lease, item)) {
+            return false;
+        }
+        return buffer_.ack(lease);
+    }
+
+    void shutdown() override { buffer_.shutdown(); }
+};
+
+// Files under a scratch directory, removed afterwards
+class ScratchDirectory {
+private:
+    std::filesystem::path path_;
+
+public:
+    explicit ScratchDirectory(const std::string& name)
+        : path_(std::filesystem::temp_directory_path() /
+                ("pc-stress-" + std::to_string(getpid()) + "-" + name)) {
+        std::filesystem::remove_all(path_);
+    }
+
+    ~ScratchDirectory() { std::filesystem::remove_all(path_); }
+
+    const std::filesystem::path& path() const { return path_; }
+};
+
+class DurableTarget : public StressTarget {
+private:
+    ScratchDirectory directory_;
+    DurableBuffer<Item> buffer_;
+
+public:
+    // Tiny WAL segments: rotation and deletion of acknowledged segments run constantly
+    explicit DurableTarget(size_t capacity) : directory_("durable"), buffer_(directory_.path(), capacity, 4096, 4096) {}
+
+    bool push(const Item& item) override { return buffer_.push_nowait(item); }
+
+    bool pop(Item& item) override {
+        uint64_t sequence;
+        if (!buffer_.pop(item, sequence)) {
+            return false;
+        }
+        buffer_.ack(sequence);
+        return true;
+    }
+
+    void shutdown() override { buffer_.shutdown(); }
+};
+
+class SpillTarget : public StressTarget {
+private:
+    ScratchDirectory directory_;
+    SpillBuffer<Item> buffer_;
+
+public:
+    // Tiny watermark and segments: most items go through the journal
+    explicit SpillTarget(size_t watermark) : directory_("spill"), buffer_(watermark, directory_.path(), 4096) {}
+
+    bool push(const Item& item) override { return buffer_.push(item); }
+    bool pop(Item& item) override { return buffer_.pop(item); }
+    void shutdown() override { buffer_.shutdown(); }
+};
+
+// Each producer keeps to one of two Buffers, so its items stay in order
+class SelectTarget : public StressTarget {
+private:
+    Buffer<Item> buffers_[2];
+
+public:
+    explicit SelectTarget(size_t capacity) : buffers_{Buffer<Item>(capacity), Buffer<Item>(capacity)} {}
+
+    bool push(const Item& item) override { return buffers_[item.producer % 2].push(item); }
+
+    // A fresh Select per call also exercises registering and removing the waiter
+    bool pop(Item& item) override {
+        Select select;
+        for (Buffer<Item>& buffer : buffers_) {
+            select.recv(buffer, [&item](Item& popped) { item = popped; });
+        }
+        return select.wait() != Select::CLOSED;
+    }
+
+    void shutdown() override {
+        for (Buffer<Item>& buffer : buffers_) {
+            buffer.shutdown();
+        }
+    }
+};
+
+#ifdef __linux__
+class SharedMemoryTarget : public StressTarget {
+private:
+    std::string name_;
+    SharedMemoryBuffer<Item> buffer_;
+
+public:
+    explicit SharedMemoryTarget(size_t capacity)
+        : name_("/pc-stress-" + std::to_string(getpid())),
+          buffer_(SharedMemoryBuffer<Item>::create(name_, capacity)) {}
+
+    ~SharedMemoryTarget() override { SharedMemoryBuffer<Item>::unlink(name_); }
+
+    bool push(const Item& item) override { return buffer_.push(item); }
+    bool pop(Item& item) override { return buffer_.pop(item); }
+    void shutdown() override { buffer_.shutdown(); }
+};
+#endif
+
+struct Backend {
+    std::string name;
+    int max_producers;
+    int max_consumers;
+    uint32_t max_items;                     // Per producer
+    bool fifo;
+    std::function<std::unique_ptr<StressTarget>(size_t capacity)> make;
+};
+
+template<typename Queue, typename... Args>
+std::unique_ptr<StressTarget> plain(Args... args) {
+    return std::make_unique<PlainTarget<Queue>>(std::make_unique<Queue>(args...));
+}
+
+struct Pop {
+    uint32_t sequence;
+    int64_t started;
+    int64_t finished;
+};
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Runs one randomized round; returns an empty string or what went wrong
+std::string run_round(const Backend& backend, std::mt19937& rng, std::string& shape) {
+    std::uniform_int_distribution<int> producers_dist(1, backend.max_producers);
+    std::uniform_int_distribution<int> consumers_dist(1, backend.max_consumers);
+    std::uniform_int_distribution<uint32_t> items_dist(backend.max_items / 4, backend.max_items);
+    const size_t CAPACITIES[] = {1, 2, 3, 8, 64};
+    int num_producers = producers_dist(rng);
+    int num_consumers = consumers_dist(rng);
+    uint32_t per_producer = items_dist(rng);
+    size_t capacity = CAPACITIES[rng() % 5];
+    unsigned seed = static_cast<unsigned>(rng());
+    shape = std::to_string(num_producers) + "P:" + std::to_string(num_consumers) + "C cap " +
+            std::to_string(capacity) + ", " + std::to_string(per_producer * num_producers) + " items";
+
+    std::unique_ptr<StressTarget> target = backend.make(capacity);
+    std::atomic<int> rejected{0};
+    // popped[c][p]: what consumer c got from producer p, in order
+    std::vector<std::vector<std::vector<Pop>>> popped(num_consumers, std::vector<std::vector<Pop>>(num_producers));
+    std::vector<std::string> violations(num_consumers);
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < num_consumers; ++c) {
+        consumers.emplace_back([&, c] {
+            Item item;
+            for (;;) {
+                int64_t started = now_ns();
+                if (!target->pop(item)) {
+                    break;
+                }
+                int64_t finished = now_ns();
+                if (item.producer >= static_cast<uint32_t>(num_producers)) {
+                    violations[c] = "garbage item from producer " + std::to_string(item.producer);
+                    continue;
+                }
+                if (finished < item.pushed_at) {
+                    violations[c] = "item popped before it was pushed";
+                }
+                popped[c][item.producer].push_back(Pop{item.sequence, started, finished});
+            }
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&, p] {
+            std::mt19937 jitter(seed + static_cast<unsigned>(p));
+            for (uint32_t i = 0; i < per_producer; ++i) {
+                if (jitter() % 64 == 0) {
+                    std::this_thread::yield();     // Shake up the interleaving
+                }
+                if (!target->push(Item{static_cast<uint32_t>(p), i, now_ns()})) {
+                    rejected++;
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    target->shutdown();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+    target.reset();
+
+    if (rejected > 0) {
+        return std::to_string(rejected.load()) + " pushes rejected before shutdown";
+    }
+    for (const std::string& violation : violations) {
+        if (!violation.empty()) {
+            return violation;
+        }
+    }
+
+    for (int p = 0; p < num_producers; ++p) {
+        std::vector<Pop> all;
+        for (int c = 0; c < num_consumers; ++c) {
+            const std::vector<Pop>& seen = popped[c][p];
+            if (backend.fifo) {
+                for (size_t i = 1; i < seen.size(); ++i) {
+                    if (seen[i].sequence <= seen[i - 1].sequence) {
+                        return "consumer " + std::to_string(c) + " got producer " + std::to_string(p) + " item " +
+                               std::to_string(seen[i].sequence) + " after " + std::to_string(seen[i - 1].sequence);
+                    }
+                }
+            }
+            all.insert(all.end(), seen.begin(), seen.end());
+        }
+
+        std::sort(all.begin(), all.end(), [](const Pop& a, const Pop& b) { return a.sequence < b.sequence; });
+        for (uint32_t i = 0; i < per_producer; ++i) {
+            if (i >= all.size() || all[i].sequence > i) {
+                return "producer " + std::to_string(p) + " item " + std::to_string(i) + " was lost";
+            }
+            if (all[i].sequence < i) {
+                return "producer " + std::to_string(p) + " item " + std::to_string(all[i].sequence) +
+                       " was delivered twice";
+            }
+        }
+        if (all.size() > per_producer) {
+            return "producer " + std::to_string(p) + " has extra deliveries";
+        }
+
+        if (backend.fifo) {
+            int64_t latest_start = INT64_MIN;   // Over all earlier items of this producer
+            for (uint32_t i = 0; i < per_producer; ++i) {
+                if (all[i].finished < latest_start) {
+                    return "producer " + std::to_string(p) + " item " + std::to_string(i) +
+                           " was popped before an earlier item's pop started";
+                }
+                latest_start = std::max(latest_start, all[i].started);
+            }
+        }
+    }
+    return "";
+}
+
+// Destroying a DelayBuffer whose ready Buffer is full and has no consumer
+// left must not hang on the timer thread blocked in push()
+std::string check_delay_buffer_teardown() {
+    auto destroyed = std::make_shared<std::promise<void>>();
+    std::future<void> done = destroyed->get_future();
+    std::thread([destroyed] {
+        {
+            DelayBuffer<Item> buffer(2);
+            for (uint32_t i = 0; i < 8; ++i) {
+                buffer.push_after(Item{0, i, 0}, std::chrono::milliseconds(0));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));    // Timer fills the ready Buffer
+        }
+        destroyed->set_value();
+    }).detach();
+    if (done.wait_for(std::chrono::seconds(10)) != std::future_status::ready) {
+        return "destructor hung with a full, unconsumed ready Buffer";
+    }
+    return "";
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = 8;
+    unsigned seed = std::random_device{}();
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--rounds") == 0) {
+            rounds = std::atoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            seed = static_cast<unsigned>(std::strtoul(argv[i + 1], nullptr, 10));
+        }
+    }
+
+    std::vector<Backend> backends = {
+        {"Buffer", 4, 4, 5000, true, [](size_t capacity) { return plain<Buffer<Item>>(capacity); }},
+        {"RingBuffer", 4, 4, 5000, true, [](size_t capacity) { return plain<RingBuffer<Item>>(capacity); }},
+        {"MpscQueue", 4, 1, 5000, true, [](size_t) { return plain<MpscQueue<Item>>(); }},
+        {"SpmcRing", 1, 4, 20000, true, [](size_t capacity) { return plain<SpmcRing<Item>>(capacity); }},
+        {"SpscRing", 1, 1, 20000, true, [](size_t capacity) { return plain<SpscRing<Item>>(capacity); }},
+        {"Select", 4, 4, 5000, true, [](size_t capacity) { return std::make_unique<SelectTarget>(capacity); }},
+        {"DelayBuffer", 4, 4, 2000, true, [](size_t capacity) { return plain<DelayBuffer<Item>>(capacity); }},
+        {"SpillBuffer", 4, 4, 2000, true,
+         [](size_t capacity) { return std::unique_ptr<StressTarget>(new SpillTarget(capacity)); }},
+        {"DurableBuffer", 4, 4, 1000, true,
+         [](size_t capacity) { return std::unique_ptr<StressTarget>(new DurableTarget(capacity)); }},
+        {"LeaseBuffer", 4, 4, 2000, false,
+         [](size_t capacity) { return std::unique_ptr<StressTarget>(new LeaseTarget(capacity)); }},
+#ifdef __linux__
+        {"SharedMemoryBuffer", 4, 4, 2000, true,
+         [](size_t capacity) { return std::unique_ptr<StressTarget>(new SharedMemoryTarget(capacity)); }},
+#endif
+    };
+
+    std::cout << "\n=== BUFFER STRESS TEST ===\n";
+    std::cout << "[MAIN] " << rounds << " rounds per backend, seed " << seed << "\n";
+    std::mt19937 rng(seed);
+    for (const Backend& backend : backends) {
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 1; round <= rounds; ++round) {
+            std::string shape;
+            std::string failure = run_round(backend, rng, shape);
+            if (!failure.empty()) {
+                std::cout << "[FAIL] " << backend.name << " round " << round << " (" << shape << "): " << failure
+                          << "\n[MAIN] Reproduce with --seed " << seed << "\n";
+                return 1;
+            }
+        }
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        std::cout << "[PASS] " << backend.name << " (" << ms.count() << " ms)\n";
+    }
+
+    std::string failure = check_delay_buffer_teardown();
+    if (!failure.empty()) {
+        std::cout << "[FAIL] DelayBuffer teardown: " << failure << "\n";
+        return 1;
+    }
+    std::cout << "[PASS] DelayBuffer teardown\n";
+
+    std::cout << "=== BUFFER STRESS TEST PASSED ===\n\n";
+    return 0;
+}
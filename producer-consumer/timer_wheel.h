@@ -0,0 +1,147 @@
+#ifndef PRODUCER_CONSUMER_TIMER_WHEEL_H
+#define PRODUCER_CONSUMER_TIMER_WHEEL_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Hierarchical Timing Wheel
+ *
+ * Keeps items that are due at some future tick. Time is an integer tick
+ * count chosen by the caller (DelayBuffer uses 1 ms ticks).
+ *
+ * There are LEVELS wheels of SLOTS slots each. Level 0 holds items due in
+ * the next 64 ticks, one slot per tick; level 1 holds items due in the next
+ * 64*64 ticks, one slot per 64 ticks; and so on. Four levels cover 2^24
+ * ticks (4.6 hours at 1 ms); anything further out sits in the last slot of
+ * the top level and is re-filed when it comes around.
+ *
+ * - insert() computes a level and slot from the distance to the due tick:
+ *   O(1), no ordering work at all
+ * - advance() walks tick by tick. Each tick empties one level-0 slot. When
+ *   a level's index wraps, the matching slot of the next level is emptied
+ *   and its items are re-filed one level down ("cascading"). Every item
+ *   cascades at most LEVELS - 1 times, so expiry is amortized O(1)
+ *
+ * Not thread-safe; DelayBuffer serializes access.
+ */
+template<typename T>
+class TimerWheel {
+public:
+    static const size_t LEVELS = 4;
+    static const size_t SLOT_BITS = 6;
+    static const size_t SLOTS = size_t(1) << SLOT_BITS;
+    static const uint64_t SPAN = uint64_t(1) << (SLOT_BITS * LEVELS);   // Ticks covered by the wheel
+
+private:
+    struct Entry {
+        uint64_t due;
+        T item;
+    };
+
+    using Slot = std::vector<Entry>;
+
+    std::array<std::array<Slot, SLOTS>, LEVELS> wheels_;
+    uint64_t current_ = 0;                  // Everything due at or before this tick has expired
+    size_t size_ = 0;
+
+    static size_t index(uint64_t tick, size_t level) {
+        return static_cast<size_t>(tick >> (SLOT_BITS * level)) & (SLOTS - 1);
+    }
+
+    // Caller guarantees due > current_
+    void file(Entry&& entry) {
+        uint64_t delta = entry.due - current_;
+        uint64_t placed = entry.due;
+        if (delta >= SPAN) {
+            placed = current_ + SPAN - 1;   // Parked; re-filed when its slot cascades
+            delta = SPAN - 1;
+        }
+        size_t level = 0;
+        while (delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+        wheels_[level][index(placed, level)].push_back(std::move(entry));
+    }
+
+    template<typename Expire>
+    void cascade(size_t level, Expire& expire) {
+        Slot slot;
+        slot.swap(wheels_[level][index(current_, level)]);
+        for (Entry& entry : slot) {
+            if (entry.due <= current_) {
+                size_--;
+                expire(std::move(entry.item));
+            } else {
+                file(std::move(entry));
+            }
+        }
+    }
+
+public:
+    // Returns false if `due` has already passed; the item is not stored then
+    // and the caller should deliver it right away
+    bool insert(uint64_t due, T& item) {
+        if (due <= current_) {
+            return false;
+        }
+        file(Entry{due, std::move(item)});
+        size_++;
+        return true;
+    }
+
+    // An empty wheel has nothing to walk past: jumps straight to `now`.
+    // Call before insert() after an idle period, so the next advance() does
+    // not walk every idle tick.
+    void skip_to(uint64_t now) {
+        if (size_ == 0) {
+            current_ = std::max(current_, now);
+        }
+    }
+
+    // Moves time forward to `now`, calling expire(T&&) for every item that
+    // has come due, in due order (items due on the same tick in any order)
+    template<typename Expire>
+    void advance(uint64_t now, Expire expire) {
+        if (size_ == 0) {
+            skip_to(now);
+            return;
+        }
+        while (current_ < now && size_ > 0) {
+            current_++;
+            // Higher levels first, so their items can drop all the way down
+            size_t wrapped = 0;
+            while (wrapped + 1 < LEVELS && index(current_, wrapped) == 0) {
+                wrapped++;
+            }
+            for (size_t level = wrapped; level > 0; --level) {
+                cascade(level, expire);
+            }
+            cascade(0, expire);
+        }
+        current_ = std::max(current_, now);
+    }
+
+    // Earliest tick at which advance() may have something to do: the next
+    // occupied level-0 slot, or else the next cascade. Only meaningful
+    // while the wheel is not empty.
+    uint64_t next_expiry() const {
+        uint64_t boundary = (current_ | (SLOTS - 1)) + 1;
+        for (uint64_t tick = current_ + 1; tick < boundary; ++tick) {
+            if (!wheels_[0][index(tick, 0)].empty()) {
+                return tick;
+            }
+        }
+        return boundary;
+    }
+
+    uint64_t current() const { return current_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+};
+
+#endif // PRODUCER_CONSUMER_TIMER_WHEEL_H
@@ -0,0 +1,206 @@
+#ifndef PRODUCER_CONSUMER_TRACE_H
+#define PRODUCER_CONSUMER_TRACE_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "tsc_clock.h"
+
+/**
+ * Timeline Trace Recorder
+ *
+ * Histograms say how long waits were; a timeline says who was waiting on
+ * whom, and when. TraceRecorder keeps begin/end events (push, pop, wait,
+ * process, ...) in a fixed ring per thread and writes them out as Chrome
+ * trace JSON, which chrome://tracing and ui.perfetto.dev both open:
+ *
+ *   PC_TRACE_THREAD("consumer 1");
+ *   { PC_TRACE_SCOPE("process"); handle(item); }
+ *   ...
+ *   TraceRecorder::instance().write_chrome_json("run.trace.json");
+ *
+ * - Recording is one rdtsc and one 16-byte store into the calling thread's
+ *   own ring: no lock, no allocation, no shared cache line. When a ring is
+ *   full the oldest events are overwritten, so a long run keeps its end
+ * - Event names must be string literals (only the pointer is stored)
+ * - Write the trace once the traced threads have stopped
+ *
+ * Buffer records "push"/"pop" and, only when it actually blocks,
+ * "wait not_full"/"wait not_empty". All PC_TRACE_* macros compile to
+ * nothing unless PRODUCER_CONSUMER_TRACE is defined, so untraced builds
+ * pay nothing.
+ */
+class TraceRecorder {
+public:
+    static const size_t DEFAULT_EVENTS_PER_THREAD = 1 << 16;
+
+private:
+    struct Event {
+        uint64_t ticks;
+        const char* name;                   // nullptr marks the end of the innermost scope
+    };
+
+    struct ThreadLog {
+        uint32_t tid;
+        std::string name;
+        std::unique_ptr<Event[]> events;
+        size_t mask;
+        std::atomic<uint64_t> written{0};   // Total events ever written (single writer)
+    };
+
+    std::mutex mutex_;                      // Registration and output only
+    std::vector<std::unique_ptr<ThreadLog>> threads_;
+    const uint64_t start_ticks_;
+    size_t events_per_thread_ = DEFAULT_EVENTS_PER_THREAD;
+
+    TraceRecorder() : start_ticks_(TscClock::ticks()) { TscClock::instance(); }
+
+    ThreadLog& local() {
+        thread_local ThreadLog* log = nullptr;
+        if (log == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto created = std::make_unique<ThreadLog>();
+            created->tid = static_cast<uint32_t>(threads_.size() + 1);
+            created->name = "thread " + std::to_string(created->tid);
+            size_t capacity = 1;
+            while (capacity < events_per_thread_) {
+                capacity <<= 1;
+            }
+            created->events.reset(new Event[capacity]);
+            created->mask = capacity - 1;
+            log = created.get();
+            threads_.push_back(std::move(created));
+        }
+        return *log;
+    }
+
+    void append(const char* name) {
+        ThreadLog& log = local();
+        uint64_t index = log.written.load(std::memory_order_relaxed);
+        log.events[index & log.mask] = Event{TscClock::ticks(), name};
+        log.written.store(index + 1, std::memory_order_release);
+    }
+
+public:
+    static TraceRecorder& instance() {
+        static TraceRecorder recorder;
+        return recorder;
+    }
+
+    // Ring size for threads that have not recorded anything yet
+    void set_events_per_thread(size_t events) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_per_thread_ = events;
+    }
+
+    void begin(const char* name) { append(name); }
+    void end() { append(nullptr); }
+
+    // Shown as the track name in the viewer
+    void name_thread(const std::string& name) {
+        ThreadLog& log = local();
+        std::lock_guard<std::mutex> lock(mutex_);
+        log.name = name;
+    }
+
+    // Events dropped because a ring wrapped
+    uint64_t overwritten() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t total = 0;
+        for (const auto& log : threads_) {
+            uint64_t written = log->written.load(std::memory_order_acquire);
+            total += written > log->mask + 1 ? written - (log->mask + 1) : 0;
+        }
+        return total;
+    }
+
+    // Writes every thread's ring as Chrome trace JSON (timestamps in us).
+    // Throws std::system_error if the file cannot be written.
+    void write_chrome_json(const std::string& path) {
+        std::FILE* out = std::fopen(path.c_str(), "w");
+        if (out == nullptr) {
+            throw std::system_error(errno, std::generic_category(), "fopen " + path);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        const TscClock& clock = TscClock::instance();
+        std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        bool first = true;
+        auto separator = [&first, out] {
+            if (!first) {
+                std::fprintf(out, ",\n");
+            }
+            first = false;
+        };
+
+        for (const auto& log : threads_) {
+            separator();
+            std::fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                         log->tid);
+            for (char c : log->name) {
+                if (c == '"' || c == '\\') {
+                    std::fputc('\\', out);
+                }
+                std::fputc(c, out);
+            }
+            std::fprintf(out, "\"}}");
+
+            uint64_t written = log->written.load(std::memory_order_acquire);
+            size_t capacity = log->mask + 1;
+            uint64_t oldest = written > capacity ? written - capacity : 0;
+            std::vector<const char*> open;  // Begin names, to label the matching ends
+            for (uint64_t i = oldest; i < written; ++i) {
+                const Event& event = log->events[i & log->mask];
+                double us = static_cast<double>(clock.to_ns(event.ticks - start_ticks_)) / 1000.0;
+                const char* name = event.name;
+                if (name == nullptr) {
+                    if (open.empty()) {
+                        continue;           // Its begin was overwritten
+                    }
+                    name = open.back();
+                    open.pop_back();
+                } else {
+                    open.push_back(name);
+                }
+                separator();
+                std::fprintf(out, "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}", name,
+                             event.name != nullptr ? 'B' : 'E', us, log->tid);
+            }
+        }
+        std::fprintf(out, "\n]}\n");
+        if (std::fclose(out) != 0) {
+            throw std::system_error(errno, std::generic_category(), "write " + path);
+        }
+    }
+};
+
+// Records a begin event now and the matching end event at scope exit
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) { TraceRecorder::instance().begin(name); }
+    ~TraceScope() { TraceRecorder::instance().end(); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#define PC_TRACE_CONCAT_(a, b) a##b
+#define PC_TRACE_CONCAT(a, b) PC_TRACE_CONCAT_(a, b)
+
+#ifdef PRODUCER_CONSUMER_TRACE
+#define PC_TRACE_SCOPE(name) TraceScope PC_TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define PC_TRACE_THREAD(name) TraceRecorder::instance().name_thread(name)
+#else
+#define PC_TRACE_SCOPE(name) ((void)0)
+#define PC_TRACE_THREAD(name) ((void)0)
+#endif
+
+#endif // PRODUCER_CONSUMER_TRACE_H
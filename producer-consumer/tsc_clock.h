@@ -0,0 +1,62 @@
+#ifndef PRODUCER_CONSUMER_TSC_CLOCK_H
+#define PRODUCER_CONSUMER_TSC_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Timestamp Counter Clock
+ *
+ * Timestamps for tracing must be cheap enough to take several times per
+ * message. TscClock::ticks() is one rdtsc instruction (no syscall, no vDSO
+ * call); instance().to_ns() converts tick differences to nanoseconds using
+ * a rate calibrated once against steady_clock. This assumes an invariant
+ * TSC, which every x86 CPU of the last decade has. On other architectures
+ * ticks are steady_clock nanoseconds.
+ */
+class TscClock {
+private:
+    double ns_per_tick_ = 1.0;
+
+    TscClock() {
+#if defined(__x86_64__) || defined(__i386__)
+        // Calibrate over ~20 ms; good to well under 0.1%
+        auto wall_start = std::chrono::steady_clock::now();
+        uint64_t tsc_start = ticks();
+        while (std::chrono::steady_clock::now() - wall_start < std::chrono::milliseconds(20)) {
+        }
+        uint64_t tsc_end = ticks();
+        auto wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wall_start).count();
+        ns_per_tick_ = static_cast<double>(wall_ns) / static_cast<double>(tsc_end - tsc_start);
+#endif
+    }
+
+public:
+    static uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Calibrated on first use
+    static const TscClock& instance() {
+        static const TscClock clock;
+        return clock;
+    }
+
+    uint64_t to_ns(uint64_t ticks) const {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * ns_per_tick_);
+    }
+
+    double ns_per_tick() const { return ns_per_tick_; }
+};
+
+#endif // PRODUCER_CONSUMER_TSC_CLOCK_H